@@ -0,0 +1,334 @@
+#include "buffer/buffer_pool_instance.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "glog/logging.h"
+
+BufferPoolInstance::BufferPoolInstance(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      pages_(static_cast<Page *>(::operator new[](pool_size * sizeof(Page)))),
+      disk_manager_(disk_manager),
+      read_only_(disk_manager->IsReadOnly()),
+      page_table_(pool_size) {
+  switch (replacer_type) {
+    case kClockReplacer:
+      replacer_ = new CLOCKReplacer(pool_size_);
+      break;
+    case kLRUKReplacer:
+      replacer_ = new LRUKReplacer(pool_size_);
+      break;
+    default:
+      replacer_ = new LRUReplacer(pool_size_);
+  }
+  // a read-only pool points its frames into the file mapping and needs no frame memory
+  if (!read_only_) {
+    frame_data_ = static_cast<char *>(aligned_alloc(PAGE_SIZE, pool_size_ * PAGE_SIZE));
+    memset(frame_data_, 0, pool_size_ * PAGE_SIZE);
+  }
+  for (size_t i = 0; i < pool_size_; i++) {
+    new (pages_ + i) Page(read_only_ ? nullptr : frame_data_ + i * PAGE_SIZE);
+    // free frames can not be pinned by a lock-free reader
+    pages_[i].pin_count_.store(-1, memory_order_relaxed);
+    free_list_.push_back(i);
+  }
+}
+
+BufferPoolInstance::~BufferPoolInstance() {
+  if (!read_only_) {
+    page_table_.ForEach([this](page_id_t page_id, frame_id_t frame_id) {
+      disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+    });
+  }
+  for (size_t i = 0; i < pool_size_; i++) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_);
+  free(frame_data_);
+  delete replacer_;
+}
+
+Page *BufferPoolInstance::FetchPage(page_id_t page_id) {
+    frame_id_t frameId;
+
+    /* 0.Fast path: if P is resident, pin it without taking the latch. */
+    if(page_table_.Find(page_id, &frameId) && TryPinResident(frameId, page_id))
+        return pages_ + frameId;
+
+    lock_guard<mutex> guard(latch_);
+
+    /* 1.If P exists, pin it and return it immediately. */
+    if(page_table_.Find(page_id, &frameId)){
+        Page *fetch_page = pages_ + frameId;
+        fetch_page->pin_count_.fetch_add(1, memory_order_acquire);
+        return fetch_page;
+    }
+
+    /* 2.If P does not exist, find a replacement page (R) from either the free list or the replacer. */
+    if(!TryToFindFreePage(&frameId)) return nullptr;
+
+    /* 3.Insert P, update P's metadata, read in the page content from disk, and then return a pointer to P.
+     **  A read-only pool does not read anything, the frame just points at the page inside the file mapping.
+     **  A page failing its checksum is not brought in, the frame goes back to the free list. */
+    Page *fetch_page = pages_ + frameId;
+    fetch_page->is_dirty_ = false;
+    bool read;
+    if(read_only_){
+        char *view = disk_manager_->GetPageView(page_id);
+        read = view != nullptr;
+        if(read) fetch_page->data_ = view;
+    }
+    else
+        read = disk_manager_->ReadPage(page_id, fetch_page->data_);
+    if(!read){
+        fetch_page->page_id_.store(INVALID_PAGE_ID, memory_order_relaxed);
+        free_list_.push_back(frameId);
+        return nullptr;
+    }
+    fetch_page->page_id_.store(page_id, memory_order_relaxed);
+    fetch_page->pin_count_.store(1, memory_order_release);
+    page_table_.Insert(page_id, frameId);
+    return fetch_page;
+}
+
+Page *BufferPoolInstance::NewPage(page_id_t page_id) {
+    if(read_only_) return nullptr;
+    lock_guard<mutex> guard(latch_);
+
+    /* 1.Pick a victim page from either the free list or the replacer, nullptr if all the pages are pinned.
+     **  A stale copy of a deleted page that stayed resident because it was pinned on deletion is reused. */
+    frame_id_t victim_frameId;
+    if(page_table_.Find(page_id, &victim_frameId)){
+        int expected = 0;
+        if(!pages_[victim_frameId].pin_count_.compare_exchange_strong(expected, -1)) return nullptr;
+        replacer_->Pin(victim_frameId);
+    }
+    else if(!TryToFindFreePage(&victim_frameId)) return nullptr;
+
+    /* 2.Update P's metadata, zero out memory and add P to the page table. */
+    Page *new_page = pages_ + victim_frameId;
+    new_page->ResetMemory();
+    new_page->is_dirty_ = false;
+    new_page->page_id_.store(page_id, memory_order_relaxed);
+    new_page->pin_count_.store(1, memory_order_release);
+    page_table_.Insert(page_id, victim_frameId);
+    return new_page;
+}
+
+bool BufferPoolInstance::DeletePage(page_id_t page_id) {
+    lock_guard<mutex> guard(latch_);
+
+    /* 1.If P does not exist, return true. */
+    frame_id_t del_frameId;
+    if(!page_table_.Find(page_id, &del_frameId))
+        return true;
+
+    /* 2.If P exists, but has a non-zero pin-count, return false. Someone is using the page. */
+    Page *del_page = pages_ + del_frameId;
+    int expected = 0;
+    if(!del_page->pin_count_.compare_exchange_strong(expected, -1)) return false;
+
+    /* 3.Otherwise, remove P from the page table, reset its metadata and return it to the free list. */
+    page_table_.Erase(page_id);
+    replacer_->Remove(del_frameId);
+    del_page->is_dirty_ = false;
+    del_page->page_id_.store(INVALID_PAGE_ID, memory_order_relaxed);
+    free_list_.push_back(del_frameId);
+    return true;
+}
+
+bool BufferPoolInstance::UnpinPage(page_id_t page_id, bool is_dirty) {
+    lock_guard<mutex> guard(latch_);
+
+    /* 1.判断该页是否在buffer中 */
+    frame_id_t frameId;
+    if(!page_table_.Find(page_id, &frameId))
+        return true;
+
+    /* 2.找到该页所在位置并修改is_dirty */
+    Page *unpin_page = pages_ + frameId;
+    if(is_dirty)                            // 若之前is_dirty为true不做修改
+        unpin_page->is_dirty_ = true;
+
+    /* 3.判断是否为最后pinned */
+    if(unpin_page->pin_count_.load() <= 0)
+        return false;
+    UnpinFrame(frameId);
+    return true;
+}
+
+bool BufferPoolInstance::FlushPage(page_id_t page_id) {
+    if(read_only_) return false;
+    lock_guard<mutex> guard(latch_);
+
+    /* 1.判断该页是否在buffer中 */
+    frame_id_t frameId;
+    if(!page_table_.Find(page_id, &frameId))
+        return false;
+
+    /* 2.找到该页并写进磁盘 */
+    Page *flush_page = pages_ + frameId;
+    disk_manager_->WritePage(page_id, flush_page->GetData());
+
+    /* 3.更新is_dirty */
+    flush_page->is_dirty_ = false;
+    return true;
+}
+
+size_t BufferPoolInstance::FlushDirtyPages(size_t max_dirty_pages, bool include_pinned) {
+  if (read_only_) {
+    return 0;
+  }
+  vector<pair<page_id_t, frame_id_t>> victims;
+  {
+    lock_guard<mutex> guard(latch_);
+
+    /* 1. 统计脏页，挑出可以写回的页 */
+    size_t dirty_count = 0;
+    for (size_t i = 0; i < pool_size_; i++) {
+      Page *page = pages_ + i;
+      int pin_count = page->pin_count_.load();
+      if (pin_count < 0 || !page->IsDirty()) {
+        continue;
+      }
+      dirty_count++;
+      if (pin_count == 0 || include_pinned) {
+        victims.emplace_back(page->page_id_, i);
+      }
+    }
+    if (dirty_count <= max_dirty_pages) {
+      return 0;
+    }
+
+    /* 2. 按页号排序以顺序写盘，只写到脏页数降到目标为止 */
+    sort(victims.begin(), victims.end());
+    victims.resize(min(victims.size(), dirty_count - max_dirty_pages));
+
+    /* 3. pin住待写回的页，防止写盘期间被替换 */
+    for (auto &victim : victims) {
+      pages_[victim.second].pin_count_.fetch_add(1, memory_order_acquire);
+    }
+  }
+
+  /* 4. 先写回分配信息，崩溃后已写盘的页不会被当作空闲页再分配 */
+  disk_manager_->FlushMetadata();
+
+  /* 5. 清除脏标记后把页拷入暂存区，写盘与校验和都取自拷贝，不会写出拷贝后仍在修改的页
+   *    拷贝期间的修改会在unpin时重新标脏，由下一次写回补上 */
+  unique_ptr<char, decltype(&free)> staging(
+      static_cast<char *>(aligned_alloc(PAGE_SIZE, max<size_t>(victims.size(), 1) * PAGE_SIZE)), &free);
+  vector<pair<page_id_t, const char *>> batch;
+  batch.reserve(victims.size());
+  for (size_t i = 0; i < victims.size(); i++) {
+    Page *page = pages_ + victims[i].second;
+    page->is_dirty_ = false;
+    char *copy = staging.get() + i * PAGE_SIZE;
+    memcpy(copy, page->GetData(), PAGE_SIZE);
+    batch.emplace_back(victims[i].first, copy);
+  }
+  disk_manager_->WritePages(batch);
+
+  for (auto &victim : victims) {
+    ReleaseFrame(victim.second);
+  }
+  return victims.size();
+}
+
+bool BufferPoolInstance::TryToFindFreePage(frame_id_t *frame_id) {
+    /* 1.Always pick from the free list first. */
+    if(!free_list_.empty()){
+        *frame_id = free_list_.front();
+        free_list_.pop_front();
+        return true;
+    }
+
+    /* 2.Otherwise evict a victim from the replacer, skipping frames pinned by a lock-free hit meanwhile. */
+    while(replacer_->Victim(frame_id)){
+        Page *victim = pages_ + *frame_id;
+        int expected = 0;
+        if(!victim->pin_count_.compare_exchange_strong(expected, -1))
+            continue;
+
+        /* 3.Write the victim back if dirty and remove it from the page table. The write goes out in the background,
+         **  the disk manager keeps a copy and serves it to a read of the page until the write is done. */
+        page_table_.Erase(victim->page_id_);
+        if(victim->IsDirty() && !read_only_){
+            disk_manager_->WritePageAsync(victim->page_id_, victim->GetData());
+            victim->is_dirty_ = false;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool BufferPoolInstance::TryPinResident(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = pages_ + frame_id;
+  int pin_count = page->pin_count_.load(memory_order_relaxed);
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1, memory_order_acquire));
+
+  // the frame may have been replaced between the lookup and the pin
+  if (page->page_id_.load(memory_order_relaxed) == page_id) {
+    return true;
+  }
+  ReleaseFrame(frame_id);
+  return false;
+}
+
+void BufferPoolInstance::ReleaseFrame(frame_id_t frame_id) {
+  Page *page = pages_ + frame_id;
+  if (page->pin_count_.fetch_sub(1, memory_order_release) == 1) {
+    lock_guard<mutex> guard(latch_);
+    if (page->pin_count_.load() == 0) {
+      replacer_->Release(frame_id);
+    }
+  }
+}
+
+bool BufferPoolInstance::PrefetchPage(page_id_t page_id, const function<void(Page *)> &visit) {
+  frame_id_t frame_id;
+
+  /* 1. 页已在buffer中：无锁pin住，访问后归还，不刷新其在replacer中的位置 */
+  if (page_table_.Find(page_id, &frame_id) && TryPinResident(frame_id, page_id)) {
+    visit(pages_ + frame_id);
+    ReleaseFrame(frame_id);
+    return true;
+  }
+
+  /* 2. 页不在buffer中：读入页面，作为一次访问交给replacer */
+  Page *page = FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  visit(page);
+  UnpinPage(page_id, false);
+  return true;
+}
+
+void BufferPoolInstance::UnpinFrame(frame_id_t frame_id) {
+  if (pages_[frame_id].pin_count_.fetch_sub(1, memory_order_release) == 1) {
+    // a lock-free hit leaves the frame in the replacer, re-insert it so that it counts as most recently used
+    replacer_->Pin(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+}
+
+// Only used for debug
+bool BufferPoolInstance::CheckAllUnpinned() {
+  lock_guard<mutex> guard(latch_);
+  bool res = true;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].pin_count_ > 0) {
+      res = false;
+      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
+    }
+  }
+  return res;
+}
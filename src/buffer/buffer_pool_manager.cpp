@@ -3,177 +3,71 @@
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
-
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances,
+                                     ReplacerType replacer_type)
     : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
-  for (size_t i = 0; i < pool_size_; i++) {
-    free_list_.push_back(i);
+  ASSERT(num_instances > 0 && num_instances <= pool_size, "Invalid number of buffer pool instances.");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    // spread the remainder over the first shards so that the total stays pool_size
+    size_t instance_size = pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    instances_.push_back(new BufferPoolInstance(instance_size, disk_manager_, replacer_type));
   }
+  prefetch_thread_ = thread(&BufferPoolManager::PrefetchWorker, this);
+  flush_thread_ = thread(&BufferPoolManager::FlushWorker, this);
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page : page_table_) {
-    FlushPage(page.first);
+  {
+    lock_guard<mutex> guard(background_latch_);
+    stop_background_ = true;
+  }
+  prefetch_cv_.notify_one();
+  flush_cv_.notify_one();
+  prefetch_thread_.join();
+  flush_thread_.join();
+  for (auto instance : instances_) {
+    delete instance;
   }
-  delete[] pages_;
-  delete replacer_;
 }
 
-/**
- * TODO: Student Implement
- */
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
-    frame_id_t frameId;
-
-    /* 1.If P does not exist, find a replacement page (R) from either the free list or the replacer.
-     **  Note that pages are always found from the free list first.  */
-    if(page_table_.find(page_id) == page_table_.end()){
-        if(!free_list_.empty()){
-            frameId = free_list_.front();
-            free_list_.pop_front();
-        }
-        else{
-            bool is_replacer = replacer_->Victim(&frameId);
-            cout << is_replacer;
-            if(!is_replacer) return nullptr;
-        }
-
-        // 1.Search the page table for the requested page (P).
-        Page *fetch_page = pages_ + frameId;
-        // 2.If R is dirty, write it back to the disk.
-        if(fetch_page->IsDirty())
-            disk_manager_->WritePage(fetch_page->page_id_, fetch_page->GetData());
-
-        // 3.Delete R from the page table and insert P.
-        page_table_.erase(fetch_page->page_id_);
-        page_table_[page_id] = frameId;
-
-        // 4.Update P's metadata, read in the page content from disk, and then return a pointer to P.
-        fetch_page->pin_count_ ++;
-        fetch_page->page_id_  = page_id;
-        fetch_page->is_dirty_ = false;
-        disk_manager_->ReadPage(page_id, fetch_page->data_);
-        replacer_->Pin(frameId);
-        return fetch_page;
-    }
-
-    /* 2.If P exists, pin it and return it immediately. */
-    else{
-        frameId = page_table_[page_id];
-        Page *fetch_page = pages_ + frameId;
-        fetch_page->pin_count_ ++;
-        replacer_->Pin(frameId);
-        return fetch_page;
-    }
+  return GetInstance(page_id)->FetchPage(page_id);
 }
 
 /**
- * TODO: Student Implement
+ * The page id comes from the disk bitmap, so it decides the shard. If that shard has no evictable frame the id is
+ * given back to the disk manager and nullptr is returned, just as a full unsharded pool would.
  */
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
-    /* 1.If all the pages in the buffer pool are pinned, return nullptr. */
-    size_t i;
-    for(i = 0; i < pool_size_; i++){
-        if(pages_[i].pin_count_ == 0) break;
-    }
-    if(i == pool_size_) return nullptr;
-
-    /* 2.Pick a victim page from either the free list or the replacer. Always pick from the free list first. */
-    frame_id_t victim_frameId;
-    if(!free_list_.empty()){
-        victim_frameId = free_list_.front();
-        free_list_.pop_front();
-    }
-    else{
-        bool is_replacer = replacer_->Victim(&victim_frameId);
-        if(!is_replacer) return nullptr;
-    }
-    /* 3.Set the page ID output parameter. Update P's metadata, zero out memory and add P to the page table. */
-    page_id = AllocatePage();
-    Page *new_page = pages_ + victim_frameId;
-    if(new_page->IsDirty()){
-        new_page->is_dirty_ = false;
-        disk_manager_->WritePage(new_page->GetPageId(), EMPTY_PAGE_DATA);
-    }
-
-    page_table_.erase(new_page->page_id_);
-    page_table_[page_id] = victim_frameId;
-    new_page->ResetMemory();
-    new_page->is_dirty_ = false;
-    new_page->page_id_  = page_id;
-    new_page->pin_count_++;
-
-    return new_page;
+  if (disk_manager_->IsReadOnly()) {
+    return nullptr;
+  }
+  page_id_t new_page_id = AllocatePage();
+  Page *new_page = GetInstance(new_page_id)->NewPage(new_page_id);
+  if (new_page == nullptr) {
+    DeallocatePage(new_page_id);
+    return nullptr;
+  }
+  page_id = new_page_id;
+  return new_page;
 }
 
-/**
- * TODO: Student Implement
- */
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-    // 0.Make sure you call DeallocatePage!
-    DeallocatePage(page_id);
-
-    // 1.If P does not exist, return true.
-    if(page_table_.find(page_id) == page_table_.end())
-        return true;
-
-    else{
-        // 1.Search the page table for the requested page (P).
-        frame_id_t del_frameId = page_table_[page_id];
-        Page *del_page = pages_ + del_frameId;
-        // 2.If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-        if(del_page->pin_count_ != 0) return false;
-
-        // 3.Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-        page_table_.erase(page_id);
-        del_page->pin_count_ = 0;
-        del_page->is_dirty_ = false;
-        del_page->page_id_ = INVALID_PAGE_ID;
-        free_list_.push_back(del_frameId);
-        return true;
-    }
+  if (disk_manager_->IsReadOnly()) {
+    return false;
+  }
+  // Make sure you call DeallocatePage!
+  DeallocatePage(page_id);
+  return GetInstance(page_id)->DeletePage(page_id);
 }
 
-/**
- * TODO: Student Implement
- */
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-    /* 1.判断该页是否在buffer中 */
-    if(page_table_.find(page_id) == page_table_.end())
-        return true;
-
-    /* 2.找到该页所在位置并修改is_dirty */
-    frame_id_t frameId = page_table_[page_id];
-    Page *unpin_page = pages_ + frameId;
-    if(!unpin_page->IsDirty())              // 若之前is_dirty为true不做修改
-        unpin_page->is_dirty_ = is_dirty;
-
-    /* 3.判断是否为最后pinned */
-    if(unpin_page->pin_count_ == 0 )
-        return false;
-    else if(--unpin_page->pin_count_ == 0)
-        replacer_->Unpin(frameId);
-    return true;
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
 }
 
-/**
- * TODO: Student Implement
- */
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-    /* 1.判断该页是否在buffer中 */
-    if(page_table_.find(page_id) == page_table_.end())
-        return false;
-
-    /* 2.找到该页并写进磁盘 */
-    Page *flush_page = pages_ + page_table_[page_id];
-    disk_manager_->WritePage(page_id, flush_page->GetData());
-
-    /* 3.更新is_dirty */
-    flush_page->is_dirty_ = false;
-    return true;
+  return GetInstance(page_id)->FlushPage(page_id);
 }
 
 page_id_t BufferPoolManager::AllocatePage() {
@@ -192,11 +86,75 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
   bool res = true;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].pin_count_ != 0) {
-      res = false;
-      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
-    }
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
   }
   return res;
-}
\ No newline at end of file
+}
+
+void BufferPoolManager::PrefetchPages(page_id_t page_id, size_t count, function<page_id_t(Page *)> next_page_id) {
+  if (page_id == INVALID_PAGE_ID || count == 0) {
+    return;
+  }
+  {
+    lock_guard<mutex> guard(background_latch_);
+    if (prefetch_queue_.size() >= MAX_PREFETCH_REQUESTS) {
+      return;
+    }
+    prefetch_queue_.push_back({page_id, count, std::move(next_page_id)});
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManager::PrefetchWorker() {
+  while (true) {
+    PrefetchRequest request;
+    {
+      unique_lock<mutex> guard(background_latch_);
+      prefetch_cv_.wait(guard, [this] { return stop_background_ || !prefetch_queue_.empty(); });
+      if (stop_background_) {
+        return;
+      }
+      request = std::move(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
+
+    page_id_t page_id = request.page_id;
+    for (size_t i = 0; i < request.count && page_id >= 0; i++) {
+      page_id_t next_page_id = INVALID_PAGE_ID;
+      bool read = GetInstance(page_id)->PrefetchPage(page_id, [&](Page *page) {
+        if (request.next_page_id != nullptr) {
+          next_page_id = request.next_page_id(page);
+        }
+      });
+      if (!read) {
+        break;
+      }
+      page_id = next_page_id;
+    }
+  }
+}
+
+size_t BufferPoolManager::FlushAllPages() {
+  size_t flushed = 0;
+  for (auto instance : instances_) {
+    flushed += instance->FlushDirtyPages(0, true);
+  }
+  disk_manager_->FlushMetadata();
+  return flushed;
+}
+
+void BufferPoolManager::FlushWorker() {
+  unique_lock<mutex> guard(background_latch_);
+  while (!flush_cv_.wait_for(guard, chrono::milliseconds(FLUSH_INTERVAL_MS), [this] { return stop_background_; })) {
+    double dirty_ratio = dirty_ratio_target_;
+    if (dirty_ratio >= 1) {
+      continue;
+    }
+    guard.unlock();
+    for (auto instance : instances_) {
+      instance->FlushDirtyPages(static_cast<size_t>(dirty_ratio * instance->GetPoolSize()), false);
+    }
+    guard.lock();
+  }
+}
@@ -0,0 +1,57 @@
+#include "buffer/clock_replacer.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages)
+    : capacity(num_pages), evictable(num_pages, 0), reference(num_pages, 0) {}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+    if(size == 0) return false;
+
+    /* 1. 转动时钟指针，引用位为1的页给予第二次机会；至多两圈必能找到 */
+    while(true){
+        size_t curr = clock_hand;
+        clock_hand = (clock_hand + 1) % capacity;
+        if(!evictable[curr]) continue;
+        if(reference[curr]){
+            reference[curr] = 0;
+            continue;
+        }
+        /* 2. 找到引用位为0的页，将其移出replacer */
+        evictable[curr] = 0;
+        size--;
+        *frame_id = static_cast<frame_id_t>(curr);
+        return true;
+    }
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+    if(evictable[frame_id]){
+        evictable[frame_id] = 0;
+        size--;
+    }
+}
+
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+    if(!evictable[frame_id]){
+        evictable[frame_id] = 1;
+        size++;
+    }
+    reference[frame_id] = 1;
+}
+
+void CLOCKReplacer::Release(frame_id_t frame_id) {
+    /* 仍在replacer中的页不置引用位，不算一次访问 */
+    if(!evictable[frame_id]){
+        Unpin(frame_id);
+    }
+}
+
+void CLOCKReplacer::Remove(frame_id_t frame_id) {
+    Pin(frame_id);
+    reference[frame_id] = 0;
+}
+
+size_t CLOCKReplacer::Size() {
+  return size;
+}
@@ -0,0 +1,54 @@
+#include "buffer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : k_(k), history_(num_pages * k, 0), access_count_(num_pages, 0), evictable_(num_pages, 0) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+size_t LRUKReplacer::EvictionKey(frame_id_t frame_id) const {
+  size_t count = access_count_[frame_id];
+  return history_[frame_id * k_ + (count < k_ ? 0 : count % k_)];
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+    /* 1. 优先淘汰访问次数不足k次的页（k距离为无穷大），其次淘汰第k次访问最早的页 */
+    std::set<Candidate> *candidates = !history_set_.empty() ? &history_set_ : &cache_set_;
+    if(candidates->empty()) return false;
+    *frame_id = candidates->begin()->second;
+    candidates->erase(candidates->begin());
+
+    /* 2. 清除被淘汰页的访问历史 */
+    evictable_[*frame_id] = 0;
+    access_count_[*frame_id] = 0;
+    return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+    if(evictable_[frame_id]){
+        CandidateSet(frame_id).erase({EvictionKey(frame_id), frame_id});
+        evictable_[frame_id] = 0;
+    }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+    if(evictable_[frame_id]) return;
+
+    /* 1. 记录本次访问 */
+    size_t &count = access_count_[frame_id];
+    history_[frame_id * k_ + count % k_] = ++current_timestamp_;
+    count++;
+
+    /* 2. 按新的k距离加入候选集合 */
+    CandidateSet(frame_id).insert({EvictionKey(frame_id), frame_id});
+    evictable_[frame_id] = 1;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+    /* 页已删除，帧上的访问历史不再属于任何页 */
+    Pin(frame_id);
+    access_count_[frame_id] = 0;
+}
+
+size_t LRUKReplacer::Size() {
+  return history_set_.size() + cache_set_.size();
+}
@@ -1,20 +1,40 @@
 #include "buffer/lru_replacer.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages){}
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : head_(static_cast<frame_id_t>(num_pages)), prev_(num_pages + 1, INVALID_FRAME_ID),
+      next_(num_pages + 1, INVALID_FRAME_ID) {
+  prev_[head_] = head_;
+  next_[head_] = head_;
+}
 
 LRUReplacer::~LRUReplacer() = default;
 
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  next_[prev_[frame_id]] = next_[frame_id];
+  prev_[next_[frame_id]] = prev_[frame_id];
+  prev_[frame_id] = next_[frame_id] = INVALID_FRAME_ID;
+  size_--;
+}
+
+void LRUReplacer::PushBack(frame_id_t frame_id) {
+  frame_id_t tail = prev_[head_];
+  prev_[frame_id] = tail;
+  next_[frame_id] = head_;
+  next_[tail] = frame_id;
+  prev_[head_] = frame_id;
+  size_++;
+}
+
 /**
  * TODO: Student Implement
  */
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-    if(Size() == 0){
-        frame_id = nullptr;
+    std::lock_guard<std::mutex> guard(latch_);
+    if(size_ == 0){
         return false;
     }
-    *frame_id = lru_list_.front();
-    lru_table_.erase(lru_list_.front());
-    lru_list_.pop_front();
+    *frame_id = next_[head_];
+    Unlink(*frame_id);
     return true;
 }
 
@@ -22,9 +42,9 @@ bool LRUReplacer::Victim(frame_id_t *frame_id) {
  * TODO: Student Implement
  */
 void LRUReplacer::Pin(frame_id_t frame_id) {
-    if(lru_table_.find(frame_id) != lru_table_.end()){
-        lru_list_.erase(lru_table_[frame_id]);
-        lru_table_.erase(frame_id);
+    std::lock_guard<std::mutex> guard(latch_);
+    if(IsLinked(frame_id)){
+        Unlink(frame_id);
     }
 }
 
@@ -32,9 +52,9 @@ void LRUReplacer::Pin(frame_id_t frame_id) {
  * TODO: Student Implement
  */
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-    if(lru_table_.find(frame_id) == lru_table_.end()){
-        lru_list_.push_back(frame_id);
-        lru_table_[frame_id] = prev(lru_list_.end());
+    std::lock_guard<std::mutex> guard(latch_);
+    if(!IsLinked(frame_id)){
+        PushBack(frame_id);
     }
 }
 
@@ -42,5 +62,6 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
  * TODO: Student Implement
  */
 size_t LRUReplacer::Size() {
-  return lru_list_.size();
-}
\ No newline at end of file
+  std::lock_guard<std::mutex> guard(latch_);
+  return size_;
+}
@@ -0,0 +1,84 @@
+#include "buffer/page_table.h"
+
+PageTable::PageTable(size_t num_frames) {
+  capacity_ = 2;
+  shift_ = 63;
+  while (capacity_ < 2 * num_frames) {
+    capacity_ <<= 1;
+    shift_--;
+  }
+  mask_ = capacity_ - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  size_t pos = HomeSlot(page_id);
+  for (size_t probe = 0; probe < capacity_; probe++) {
+    uint64_t slot = slots_[pos].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      *frame_id = SlotFrameId(slot);
+      return true;
+    }
+    pos = (pos + 1) & mask_;
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  ASSERT(page_id >= 0, "Invalid page id.");
+  size_t pos = HomeSlot(page_id);
+  while (true) {
+    uint64_t slot = slots_[pos].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || SlotPageId(slot) == page_id) {
+      if (slot == EMPTY_SLOT) {
+        ASSERT(size_ < capacity_ - 1, "Page table is full.");
+        size_++;
+      }
+      slots_[pos].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    pos = (pos + 1) & mask_;
+  }
+}
+
+bool PageTable::Erase(page_id_t page_id) {
+  /* 1. 找到待删除的槽位 */
+  size_t hole = HomeSlot(page_id);
+  while (true) {
+    uint64_t slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask_;
+  }
+
+  /* 2. 向后扫描同一探测链，把可以前移的表项移入空洞（backward shift），避免留下墓碑 */
+  size_t pos = hole;
+  while (true) {
+    pos = (pos + 1) & mask_;
+    uint64_t slot = slots_[pos].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeSlot(SlotPageId(slot));
+    // the entry may move into the hole only if its home slot is not cyclically in (hole, pos]
+    if (((pos - home) & mask_) >= ((pos - hole) & mask_)) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = pos;
+    }
+  }
+
+  /* 3. 清空最终的空洞 */
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+  return true;
+}
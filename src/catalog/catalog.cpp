@@ -127,7 +127,8 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   page_id_t page_id;
   auto table_meta_page = buffer_pool_manager_->NewPage(page_id);
   auto table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_);
-  auto table_meta = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), schema);
+  auto table_meta = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), schema,
+                                          table_heap->GetFreeSpaceMapPageId());
 
   table_meta->SerializeTo(table_meta_page->GetData());
 
@@ -199,17 +200,24 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     key_map.push_back(col_idx);
   }
 
-  /* 3. 初始化index_info并建立映射关系 */
+  /* 2. 初始化index_info，键过长时建不成索引 */
   auto index_id = catalog_meta_->GetNextIndexId();
+  auto index_meta = IndexMetadata::Create(index_id, index_name, table_names_[table_name], key_map);
+  index_info = IndexInfo::Create();
+  index_info->Init(index_meta, table_info, buffer_pool_manager_);
+  if (index_info->GetIndex() == nullptr) {
+    delete index_info;
+    index_info = nullptr;
+    return DB_FAILED;
+  }
+
+  /* 3. 写入索引元信息并建立映射关系 */
   index_names_[table_name][index_name] = index_id;
   page_id_t page_id;
   auto index_meta_page =  buffer_pool_manager_->NewPage(page_id);
   catalog_meta_->index_meta_pages_[index_id] = page_id;
-  buffer_pool_manager_->UnpinPage(page_id, true);
-  auto index_meta = IndexMetadata::Create(index_id, index_name, table_names_[table_name], key_map);
   index_meta->SerializeTo(index_meta_page->GetData());
-  index_info = IndexInfo::Create();
-  index_info->Init(index_meta, table_info, buffer_pool_manager_);
+  buffer_pool_manager_->UnpinPage(page_id, true);
   indexes_[index_id] = index_info;
 
   return DB_SUCCESS;
@@ -262,6 +270,7 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   page_id_t page_id = catalog_meta_->table_meta_pages_[table_id];
   catalog_meta_->table_meta_pages_.erase(table_id);
   buffer_pool_manager_->DeletePage(page_id);
+  tables_[table_id]->GetTableHeap()->DeleteTable();
   tables_.erase(table_id);
 
   return DB_SUCCESS;
@@ -321,7 +330,7 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   /* 1.2. 建立该表的TableHeap */
   auto table_heap = TableHeap::Create(buffer_pool_manager_,
                                         table_meta->GetFirstPageId(), table_meta->GetSchema(),
-                                        log_manager_, lock_manager_);
+                                        log_manager_, lock_manager_, table_meta->GetFreeSpaceMapPageId());
   /* 1.3. 初始化TableInfo */
   table_info->Init(table_meta, table_heap);
 
@@ -353,6 +362,10 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
   /* 1.2. 初始化IndexInfo */
   table_id_t table_id = index_meta->GetTableId();
   index_info->Init(index_meta, tables_[table_id], buffer_pool_manager_);
+  if (index_info->GetIndex() == nullptr) {
+    delete index_info;
+    return DB_FAILED;
+  }
 
   /* 2.更新 CatalogManager 里的信息 (map for indexes) */
   indexes_[index_id] = index_info;
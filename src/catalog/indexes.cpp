@@ -83,10 +83,12 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
 }
 
 Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
-  size_t max_size = 0;
+  /* 含unique列的键不会重复，否则键后附上RowId */
+  bool unique = false;
   for (auto col : key_schema_->GetColumns(0)) {
-    max_size += col->GetLength();
+    unique = unique || col->IsUnique();
   }
+  size_t max_size = KeyManager::GetEncodedSize(key_schema_, unique);
 
   if (index_type == "bptree") {
     if (max_size <= 8)
@@ -99,12 +101,14 @@ Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const stri
       max_size = 128;
     else if (max_size <= 248)
       max_size = 256;
+    else if (max_size <= MAX_ENCODED_KEY_SIZE)
+      max_size = 512;
     else {
-      LOG(ERROR) << "GenericKey size is too large";
+      LOG(ERROR) << "GenericKey size is too large: " << max_size << " bytes encoded";
       return nullptr;
     }
   } else {
     return nullptr;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager, unique);
 }
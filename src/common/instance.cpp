@@ -3,16 +3,26 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
-    : db_file_name_(std::move(db_name)), init_(init) {
+#include <unistd.h>
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances, ReplacerType replacer_type, bool read_only,
+                                 bool checksums)
+    : db_file_name_(std::move(db_name)), init_(init), read_only_(read_only) {
+  ASSERT(!(init_ && read_only_), "A read-only database can not be initialized.");
   // Init database file if needed
   db_file_name_ = "./databases/"+db_file_name_;
+  std::string checksum_file_name = db_file_name_ + ".crc";
   if (init_) {
     remove(db_file_name_.c_str());
+    remove(checksum_file_name.c_str());
+  } else if (access(checksum_file_name.c_str(), F_OK) == 0) {
+    // pages written without checksums would leave stale ones behind
+    checksums = true;
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  disk_mgr_ = new DiskManager(db_file_name_, false, read_only_, checksums);
+  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, buffer_pool_instances, replacer_type);
 
   // Allocate static page for db storage engine
   if (init) {
@@ -65,7 +65,10 @@ bool DeleteExecutor::Next(Row *row, RowId *rid) {
 
       return true;
     }
+    return false;
   }
 
+  /* 3. 扫描结束，删除留下的空页足够多时整理表 */
+  tableHeap->AutoVacuum(nullptr);
   return false;
 }
\ No newline at end of file
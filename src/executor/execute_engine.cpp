@@ -35,6 +35,10 @@ ExecuteEngine::ExecuteEngine() {
         strcmp( stdir->d_name , "..") == 0 ||
         stdir->d_name[0] == '.')
       continue;
+    /* 校验和文件随数据库文件一起打开，不是单独的数据库 */
+    string file_name(stdir->d_name);
+    if(file_name.size() > 4 && file_name.compare(file_name.size() - 4, 4, ".crc") == 0)
+      continue;
     dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
   }
   // end of comment
@@ -88,7 +92,7 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
     Row row{};
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
-        result_set->push_back(row);
+        result_set->push_back(std::move(row));
       }
     }
   } catch (const exception &ex) {
@@ -140,6 +144,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
     default:
       break;
   }
@@ -511,6 +517,7 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   if(if_create_success != DB_SUCCESS)
     return if_create_success;
   CatalogManager* current_CMgr = dbs_[current_db_]->catalog_mgr_;
+  vector<string> created_index_names;
   for(const string& column_name_stp: column_names)
   {
     /* 这里不清楚到底是用unique还是primary——都用，测试的时候可以删掉unique的索引 */
@@ -521,8 +528,21 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
       IndexInfo* stp_index_info;
       dberr_t if_create_index_success
           = current_CMgr->CreateIndex(new_table_name, stp_index_name, index_columns_stp,nullptr, stp_index_info, "bptree");
+      /* 主键过长建不成索引时，表和已建的索引也不保留 */
       if(if_create_index_success != DB_SUCCESS)
+      {
+        for(const string& created_index_name : created_index_names)
+        {
+          IndexInfo* created_index_info;
+          if(current_CMgr->GetIndex(new_table_name, created_index_name, created_index_info) == DB_SUCCESS)
+            current_CMgr->DropIndex(new_table_name, created_index_name);
+        }
+        current_CMgr->DropTable(new_table_name);
+        if(if_create_index_success == DB_FAILED)
+          std::cout << "Error: primary key " << column_name_stp << " too large to be indexed" << endl;
         return if_create_index_success;
+      }
+      created_index_names.push_back(stp_index_name);
     }
   }
 
@@ -613,37 +633,11 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     pSnode_colum_list = pSnode_colum_list->next_;
   }
 
-  /* 2. 寻找索引是否存在 */
+  /* 2. 检查索引列是否存在。非unique的列也可以建立索引，键可以重复 */
   Schema* target_schema = target_table->GetSchema();
   for(const string& tmp_colum_name: vec_index_colum_lists)
   {
-    bool if_could = false;
-    vector<string> uni_colum_list = target_table->GetMeta()->uni_keys;
-    // LOG(INFO) << uni_colum_list[0] << endl;
-
-    /* 2.1. 检验该columnName是否可以建立索引项 */
-    TableInfo *tableInfo;
-    context->GetCatalog()->GetTable(table_name, tableInfo);
-
-    for(auto it: tableInfo->GetSchema()->GetColumns(0))
-    {
-      std::string name;
-
-      name = it->GetName();
-
-      if(name == tmp_colum_name && it->IsUnique())
-      {
-        if_could = true;
-        break;
-      }
-    }
-    if(!if_could)
-    {
-      std::cout << "Error: Can't build index on column(s) not unique." << endl;
-      return DB_FAILED;
-    }
-
-    /* 2.2. 获取索引项下标 */
+    /* 2.1. 获取索引项下标 */
     uint32_t tmp_index;
     dberr_t if_getColumn_success = target_schema->GetColumnIndex(tmp_colum_name, tmp_index);
     if(if_getColumn_success != DB_SUCCESS)
@@ -655,6 +649,8 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   dberr_t if_createIndex_success = current_CMgr->CreateIndex
                                    (table_name, index_name, vec_index_colum_lists, nullptr,
                                     new_indexInfo, "bptree");
+  if(if_createIndex_success == DB_FAILED)
+    std::cout << "Error: key of index " << index_name << " too large" << endl;
   if(if_createIndex_success != DB_SUCCESS)
     return if_createIndex_success;
 
@@ -853,4 +849,28 @@ void ExecuteEngine::SaveDBs()
     out_file_stream << db_info.second << endl;
     out_file_stream.close();
   }
-}
\ No newline at end of file
+}
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    cout << "No database selected." << endl;
+    return DB_FAILED;
+  }
+  if (ast == nullptr || ast->child_ == nullptr)
+    return DB_FAILED;
+
+  /* 1. 查找表 */
+  string table_name(ast->child_->val_);
+  TableInfo *table_info;
+  dberr_t if_gettable_success = dbs_[current_db_]->catalog_mgr_->GetTable(table_name, table_info);
+  if (if_gettable_success != DB_SUCCESS)
+    return if_gettable_success;
+
+  /* 2. 整理表并报告回收的空间 */
+  size_t reclaimed = table_info->GetTableHeap()->Vacuum(nullptr);
+  cout << "Table " << table_name << " vacuumed, " << reclaimed << " bytes reclaimed." << endl;
+  return DB_SUCCESS;
+}
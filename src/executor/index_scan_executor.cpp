@@ -1,4 +1,5 @@
 #include "executor/executors/index_scan_executor.h"
+#include <iterator>
 #include <queue>
 #include "planner/expressions/constant_value_expression.h"
 #include <algorithm>
@@ -12,8 +13,8 @@
 IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-bool cmp(RowId &a, RowId &b){
-  return a.Get() == b.Get();
+bool cmp(const RowId &a, const RowId &b){
+  return a.Get() < b.Get();
 }
 
 void IndexScanExecutor::Init() {
@@ -50,7 +51,7 @@ void IndexScanExecutor::Init() {
   /* 2. 得到comparison节点，判断是不是index里的节点 */
   std::vector<RowId> results;
   Row indexKey;
-  IndexInfo *indexInfo;
+  IndexInfo *indexInfo = nullptr;
   bool flag = false;
   for(auto it : compNodes) {
     int isFound = 0;
@@ -58,12 +59,14 @@ void IndexScanExecutor::Init() {
       /* 2.1. 找到了ColumnExpression节点，检验其对应下标是否与index中的一致 */
       if (childIt->GetType() == ExpressionType::ColumnExpression) {
         auto *index = reinterpret_cast<ColumnValueExpression *>(childIt.get());
-        for (unsigned int i = 0; i < plan_->indexes_.size(); i++) {
-          indexInfo = plan_->indexes_[i];
-          std::vector<uint32_t> kMap = indexInfo->GetMeta()->GetKeyMapping();
+        /* 扫描列所在的那个索引，而不是最后一个索引 */
+        for (auto candidate : plan_->indexes_) {
+          std::vector<uint32_t> kMap = candidate->GetMeta()->GetKeyMapping();
           if (find(kMap.begin(), kMap.end(), index->GetColIdx()) != kMap.end()) {
+            indexInfo = candidate;
             indexComp = *reinterpret_cast<ComparisonExpression *>(it);
             isFound++;
+            break;
           }
         }
       } else {
@@ -81,14 +84,18 @@ void IndexScanExecutor::Init() {
         std::string comparator = indexComp.GetComparisonType();
         auto *bpIndex = reinterpret_cast<BPlusTreeIndex *>(indexInfo->GetIndex());
         if(!flag) {
-          bpIndex->ScanKey(indexKey, results, nullptr, comparator);
-          list = results;
+          bpIndex->ScanKey(indexKey, list, nullptr, comparator);
+          std::sort(list.begin(), list.end(), cmp);
           flag = true;
         }
         else {
+          /* 非唯一索引一个键对应多行，按RowId排序后求交集 */
           std::vector<RowId> tmp;
           bpIndex->ScanKey(indexKey, tmp, nullptr, comparator);
-          set_intersection(results.begin(), results.end(), tmp.begin(), tmp.end(), list.begin(), cmp);
+          std::sort(tmp.begin(), tmp.end(), cmp);
+          results.clear();
+          std::set_intersection(list.begin(), list.end(), tmp.begin(), tmp.end(), std::back_inserter(results), cmp);
+          list.swap(results);
         }
         break;
       }
@@ -116,34 +123,18 @@ bool IndexScanExecutor::Next(Row *row, RowId *rid) {
   // 当没有where时，应该是空指针
 
   Field mark(kTypeInt, CmpBool::kTrue);
-  auto it = list.begin();
-  int i = 0;
 
-  if(!list.empty())
+  /* 逐个取出索引找到的行，跳过不满足其余条件的行 */
+  while(cursor_ < list.size())
   {
-    Row *tmp = new Row(list[0]);
-    tableHeap->GetTuple(tmp, nullptr);
-    /* 筛选条件存在 */
-    if(filter) {
-      while (!filter->Evaluate(tmp).CompareEquals(mark)) {
-        delete tmp;
-        list.erase(it);
-        i++;
-        it++;
-        if(i >= list.size())  return false;
-        tmp = new Row(list[i]);
-        tableHeap->GetTuple(tmp, nullptr);
-      }
-    }
+    Row tuple(list[cursor_++]);
+    tableHeap->GetTuple(&tuple, nullptr);
+    if(filter && !filter->Evaluate(&tuple).CompareEquals(mark))
+      continue;
 
-    tableHeap->GetTuple(tmp, nullptr);
-    *row = *tmp;
-    *rid = tmp->GetRowId();
-    row->GetKeyFromRow(schemaIn, schemaOut, *row);
+    *rid = tuple.GetRowId();
     // 输出需要按照OutputSchema格式
-    delete tmp;
-    list.erase(it);
-
+    tuple.GetKeyFromRow(schemaIn, schemaOut, *row);
     return true;
   }
 
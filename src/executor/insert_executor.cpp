@@ -12,59 +12,96 @@ InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *p
  ** ExecuteContext: CatalogManager + BufferPoolManager
  ** InsertPlanNode: (output_schema) + table_name
  ** child_executor: values_executor: 其next方法返回下一个用于插入的元组
+ * 元组按批插入：一批最多INSERT_BATCH_SIZE行，先整体检查唯一性，再一次交给TableHeap，
+ * 最后按键序更新索引；Next依次返回这一批中插入成功的行
  * */
 
 void InsertExecutor::Init() {
   child_executor_->Init();
+  CatalogManager *catalog = exec_ctx_->GetCatalog();
+  catalog->GetTable(plan_->GetTableName(), table_info_);
+  indexes_.clear();
+  catalog->GetTableIndexes(plan_->GetTableName(), indexes_);
+  batch_.clear();
+  cursor_ = 0;
+  finished_ = false;
 }
 
 /* 可能需要validate得到的value类型（待定） */
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  /* 0. 获取相关表 */
-  CatalogManager *catalog = exec_ctx_->GetCatalog();
-  std::string tableName = plan_->GetTableName();
-  TableInfo *tableInfo;
-  TableHeap *tableHeap;
-  catalog->GetTable(tableName, tableInfo);
-  tableHeap = tableInfo->GetTableHeap();
-  const Schema *schemaOut, *schemaIn = tableInfo->GetSchema();
-
-  /* 1. 获取values_executor中的元组 */
-  if(child_executor_->Next(row, nullptr)) {
-    uint32_t col = 0;
+  /* 1. 当前批已返回完，插入下一批 */
+  while (cursor_ == batch_.size()) {
+    if (finished_) return false;
+    InsertBatch();
+  }
 
-    /* ! 检测该row是否违背primary或unique属性 ! */
-    Row indexKey = *row;
-    std::vector<IndexInfo *> indexes;
+  /* 2. 返回下一条插入成功的元组 */
+  *row = batch_[cursor_];
+  *rid = row->GetRowId();
+  cursor_++;
+  return true;
+}
 
-    catalog->GetTableIndexes(tableName, indexes);
+void InsertExecutor::InsertBatch() {
+  batch_.clear();
+  cursor_ = 0;
 
-    for(auto it : indexes)
-    {
-      std::vector<RowId> tmp;
+  /* 1. 从values_executor取出一批元组 */
+  Row row;
+  while (batch_.size() < INSERT_BATCH_SIZE && child_executor_->Next(&row, nullptr)) {
+    batch_.push_back(std::move(row));
+  }
+  if (batch_.size() < INSERT_BATCH_SIZE) finished_ = true;
+  if (batch_.empty()) return;
 
-      schemaOut = it->GetIndexKeySchema();
-      indexKey.GetKeyFromRow(schemaIn, schemaOut, indexKey);
-      it->GetIndex()->ScanKey(indexKey, tmp, nullptr);
-      if(!tmp.empty())
-      {
-        cout << "Error: violated primary/unique attribute on table " << tableName << endl;
-        return false;
-      }
+  /* 2. 取出每个索引的键并排序，检测是否违背primary或unique属性：
+   * 与表中已有键重复，或与本批中更早的行重复，只插入第一个违背之前的行 */
+  const Schema *schemaIn = table_info_->GetSchema();
+  std::vector<std::vector<std::pair<Row, size_t>>> keys(indexes_.size());
+  size_t valid = batch_.size();
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    keys[i].resize(batch_.size());
+    for (size_t pos = 0; pos < batch_.size(); pos++) {
+      batch_[pos].GetKeyFromRow(schemaIn, indexes_[i]->GetIndexKeySchema(), keys[i][pos].first);
+      keys[i][pos].second = pos;
     }
-
-    /* 2. 插入元组 */
-    tableHeap->InsertTuple(*row, nullptr);
-    *rid = row->GetRowId();
-    for(auto index : indexes) {
-        /* 2.1. 检查是否包含索引，如果有，更新索引 */
-        Row tmp;
-        row->GetKeyFromRow(schemaIn, index->GetIndexKeySchema(), tmp);
-        index->GetIndex()->InsertEntry(tmp, *rid, nullptr);
+    std::sort(keys[i].begin(), keys[i].end(), [](const std::pair<Row, size_t> &a, const std::pair<Row, size_t> &b) {
+      int cmp = a.first.CompareTo(b.first);
+      return cmp != 0 ? cmp < 0 : a.second < b.second;
+    });
+    if (!indexes_[i]->GetIndex()->IsUnique()) continue;  // 非唯一索引允许重复键
+    for (size_t k = 0; k < keys[i].size(); k++) {
+      if (keys[i][k].second >= valid) continue;
+      if (k > 0 && keys[i][k - 1].first.CompareTo(keys[i][k].first) == 0) {
+        valid = keys[i][k].second;
+        continue;
+      }
+      /* 键有序，相邻的查找落在同一批叶子页上 */
+      std::vector<RowId> tmp;
+      indexes_[i]->GetIndex()->ScanKey(keys[i][k].first, tmp, nullptr);
+      if (!tmp.empty()) valid = keys[i][k].second;
     }
+  }
+  if (valid < batch_.size()) {
+    cout << "Error: violated primary/unique attribute on table " << plan_->GetTableName() << endl;
+    batch_.resize(valid);
+    finished_ = true;
+  }
 
-    return true;
+  /* 3. 整批插入元组 */
+  if (!table_info_->GetTableHeap()->InsertTuples(batch_, nullptr)) {
+    cout << "Error: row too large or out of pages for table " << plan_->GetTableName() << endl;
+    batch_.clear();
+    finished_ = true;
+    return;
   }
 
-  return false;
-}
\ No newline at end of file
+  /* 4. 按键序更新索引 */
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    for (auto &key : keys[i]) {
+      if (key.second < valid) {
+        indexes_[i]->GetIndex()->InsertEntry(key.first, batch_[key.second].GetRowId(), nullptr);
+      }
+    }
+  }
+}
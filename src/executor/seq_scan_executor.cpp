@@ -19,58 +19,136 @@ void SeqScanExecutor::Init() {
    ** catalog */
   const std::string tableName = plan_->GetTableName();
   CatalogManager *catalog = GetExecutorContext()->GetCatalog();
+  StopWorkers();
 
-  /* 1. 找到表头 */
+  /* 1. 找到表头
+   * 输出列在表中的下标由plan在生成时算好，这里不再按列名查找 */
   TableInfo *targetInfo;
-  TableHeap *target;
   catalog->GetTable(tableName, targetInfo);
-  target = targetInfo->GetTableHeap();
-  tableIt = target->Begin(nullptr);
-  end = target->End();
+  TableHeap *tableHeap = targetInfo->GetTableHeap();
+
+  /* 2. 只解码输出和筛选条件用到的列 */
+  projection_ = std::make_unique<RowProjection>(targetInfo->GetSchema(), plan_->GetReferencedColumns());
+
+  /* 3. 不允许并行或表不足两个分段时，打开游标顺序扫描 */
+  std::vector<page_id_t> pageIds;
+  if (plan_->IsParallel()) {
+    pageIds = tableHeap->GetPageIds();
+  }
+  if (pageIds.size() <= static_cast<size_t>(SCAN_MORSEL_PAGES)) {
+    cursor_ = std::make_unique<TableScanCursor>(tableHeap);
+    cursor_->SetProjection(projection_.get());
+    return;
+  }
+
+  /* 4. 按页切成分段，启动工作线程 */
+  cursor_.reset();
+  for (size_t i = 0; i < pageIds.size(); i += SCAN_MORSEL_PAGES) {
+    auto end = pageIds.begin() + std::min(i + SCAN_MORSEL_PAGES, pageIds.size());
+    morsels_.emplace_back(pageIds.begin() + i, end);
+  }
+  morsel_rows_.resize(morsels_.size());
+  morsel_done_.assign(morsels_.size(), false);
+  size_t workerCount = std::min(static_cast<size_t>(SCAN_WORKER_THREADS), morsels_.size());
+  for (size_t i = 0; i < workerCount; i++) {
+    workers_.emplace_back(&SeqScanExecutor::ScanMorsels, this, tableHeap);
+  }
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
-  /* 0. 获取sequential scan中的筛选条件对应的expression tree和
-   *    输入与输出输出Schema */
-  AbstractExpressionRef filter = plan_->GetPredicate();
-  const std::string tableName = plan_->GetTableName();
-  // --------------------------------------------------------------
-  CatalogManager *catalog = GetExecutorContext()->GetCatalog();
-  TableInfo *targetInfo;
-  catalog->GetTable(tableName, targetInfo);
-  // --------------------------------------------------------------
-  const Schema *schemaOut = GetOutputSchema(),
-               *schemaIn = targetInfo->GetSchema();
+  /* 1. 顺序扫描 */
+  if (cursor_ != nullptr) {
+    if (!NextMatch(cursor_.get(), row)) return false;
+    *rid = row->GetRowId();
+    return true;
+  }
+
+  /* 2. 并行扫描：按堆中顺序逐段取出工作线程的结果 */
+  while (output_pos_ == output_rows_.size()) {
+    if (next_output_ == morsels_.size()) return false;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this] { return morsel_done_[next_output_]; });
+      output_rows_ = std::move(morsel_rows_[next_output_]);
+      output_pos_ = 0;
+      next_output_++;
+    }
+    // 输出前进，等待中的工作线程可以领取新的分段
+    cv_.notify_all();
+  }
+  *row = std::move(output_rows_[output_pos_++]);
+  *rid = row->GetRowId();
+  return true;
+}
+
+bool SeqScanExecutor::NextMatch(TableScanCursor *cursor, Row *row) {
   // 当有where的时候，predicate为非空指针，且应该一定是comparison或logic类型expression
   // 该expression返回类型一定为Field(kTypeInt, CmpBool::kTrue/kFalse)
   // 当没有where时，应该是空指针
-
+  AbstractExpressionRef filter = plan_->GetPredicate();
   Field mark(kTypeInt, CmpBool::kTrue);
 
-  /* !!!1. 对expression tree做遍历，找到查询语句的筛选条件
-   * 以目前对框架的理解，expression tree会从根节点递归向下进行条件筛选
-   * 当条件结果为CmpBool::kTrue时，说明该row符合条件 */
-  if(tableIt != end)
-  {
-    Row *tmp = new Row(tableIt.operator*());
-    /* 筛选条件存在 */
-    if(filter) {
-      while (!filter->Evaluate(tmp).CompareEquals(mark)) {
-        delete tmp;
-        tableIt++;
-        if(tableIt == end)  return false;
-        tmp = new Row(tableIt.operator*());
-      }
+  /* 在页内直接对元组求筛选条件，只有符合条件的元组才拷贝出来 */
+  while (cursor->Next()) {
+    const RowView &view = cursor->Get();
+    if (filter && filter->EvaluateView(&view).CompareEquals(mark) != CmpBool::kTrue) {
+      continue;
     }
-    /* 筛选条件不存在 */
-    *row = *tmp;
-    *rid = tmp->GetRowId();
-    row->GetKeyFromRow(schemaIn, schemaOut, *row);
-    // 输出需要按照OutputSchema格式
-    delete tmp;
-    tableIt++;
+    view.ToRow(plan_->GetOutputColumns(), row);
     return true;
   }
-
   return false;
 }
+
+void SeqScanExecutor::ScanMorsels(TableHeap *table_heap) {
+  // 工作线程最多领先输出这么多个分段，限制缓存的行数
+  const size_t window = 2 * SCAN_WORKER_THREADS;
+  while (true) {
+    /* 1. 领取下一个分段 */
+    size_t morsel;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this, window] {
+        return stopping_ || next_morsel_ == morsels_.size() || next_morsel_ < next_output_ + window;
+      });
+      if (stopping_ || next_morsel_ == morsels_.size()) return;
+      morsel = next_morsel_++;
+    }
+
+    /* 2. 不持锁扫描分段内的页 */
+    std::vector<Row> rows;
+    TableScanCursor cursor(table_heap, morsels_[morsel]);
+    cursor.SetProjection(projection_.get());
+    Row row;
+    while (NextMatch(&cursor, &row)) {
+      rows.push_back(std::move(row));
+    }
+    cursor.Close();
+
+    /* 3. 交出结果 */
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      morsel_rows_[morsel] = std::move(rows);
+      morsel_done_[morsel] = true;
+    }
+    cv_.notify_all();
+  }
+}
+
+void SeqScanExecutor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  morsels_.clear();
+  morsel_rows_.clear();
+  morsel_done_.clear();
+  output_rows_.clear();
+  next_morsel_ = next_output_ = output_pos_ = 0;
+  stopping_ = false;
+}
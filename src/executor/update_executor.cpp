@@ -19,74 +19,77 @@ UpdateExecutor::UpdateExecutor(ExecuteContext *exec_ctx, const UpdatePlanNode *p
 
 void UpdateExecutor::Init() {
   child_executor_->Init();
+  CatalogManager *catalog = exec_ctx_->GetCatalog();
+  catalog->GetTable(plan_->GetTableName(), table_info_);
+  index_info_.clear();
+  catalog->GetTableIndexes(plan_->GetTableName(), index_info_);
 }
 
 bool UpdateExecutor::Next(Row *row, RowId *rid) {
-  /* 0. 获取相关表 */
-  CatalogManager *catalog = exec_ctx_->GetCatalog();
-  std::string tableName = plan_->GetTableName();
-  TableInfo *tableInfo;
-  TableHeap *tableHeap;
-  catalog->GetTable(tableName, tableInfo);
-  tableHeap = tableInfo->GetTableHeap();
+  TableHeap *tableHeap = table_info_->GetTableHeap();
+  Schema *schema = table_info_->GetSchema();
 
   /* 1. 获取SeqScanExecutor中的元组
    * 按照SeqScanExecutor的逻辑，row和rid本身地址来自ExecutePlan，值来自SeqScanExecutor */
   if(child_executor_->Next(row, rid))
   {
-    /* 2. 更新 */
-    /* 2.2. 检查是否包含索引，如果有，更新索引 */
-    Schema *schema = tableInfo->GetSchema();
-    const std::vector<Column *> columns = schema->GetColumns(0);
-    std::vector<IndexInfo *> tmp;
-    catalog->GetTableIndexes(tableName, tmp);
     Row newTuple = GenerateUpdatedTuple(*row); // 获取更新的新元组
 
-    for(auto index : tmp)
+    /* 2. 找出键被修改的索引，新键不能违背primary或unique属性 */
+    std::vector<std::pair<Row, Row>> keys(index_info_.size());  // <旧键, 新键>
+    std::vector<bool> keyChanged(index_info_.size(), false);
+    for(size_t i = 0; i < index_info_.size(); i++)
     {
-      for (auto it2 : columns)
+      row->GetKeyFromRow(schema, index_info_[i]->GetIndexKeySchema(), keys[i].first);
+      newTuple.GetKeyFromRow(schema, index_info_[i]->GetIndexKeySchema(), keys[i].second);
+      if(keys[i].first.CompareTo(keys[i].second) == 0)
+        continue;
+      keyChanged[i] = true;
+      if(!index_info_[i]->GetIndex()->IsUnique())  // 非唯一索引允许重复键
+        continue;
+      std::vector<RowId> result;
+      index_info_[i]->GetIndex()->ScanKey(keys[i].second, result, nullptr);
+      if(!result.empty())
       {
-        uint32_t col;
-        schema->GetColumnIndex(it2->GetName(), col);
-        std::vector<uint32_t> kMap = index->GetMeta()->GetKeyMapping();
-        if(find(kMap.begin(), kMap.end(), col) != kMap.end()) {
-          Row tmpRow, removal;
-          std::vector<RowId> result;
-          newTuple.GetKeyFromRow(schema, index->GetIndexKeySchema(), tmpRow);
-          row->GetKeyFromRow(schema, index->GetIndexKeySchema(), removal);
-          index->GetIndex()->ScanKey(tmpRow, result, nullptr);
-          if(result.empty())
-          {
-            tableHeap->MarkDelete(*rid, nullptr);
-            tableHeap->ApplyDelete(*rid, nullptr);
-            tableHeap->InsertTuple(newTuple, nullptr);
-            index->GetIndex()->InsertEntry(tmpRow, newTuple.GetRowId(), nullptr);
-            index->GetIndex()->RemoveEntry(removal, *rid, nullptr);
-            // cout << "Index affected." << endl;
+        // cout << "Error: updated tuples violated primary/unique key attribute." << endl;
+        return false;
+      }
+    }
 
-            return true;
-          }
-          else
-          {
-            // cout << "Error: updated tuples violated primary/unique key attribute." << endl;
-            return false;
-          }
-        }
+    /* 3. 新元组放得下时原地更新，RowId不变；否则先标记删除旧元组再插入新元组，
+     * 插入成功才真正删除旧元组，失败则恢复旧元组 */
+    newTuple.SetRowId(*rid);
+    if(!tableHeap->UpdateTuple(newTuple, *rid, nullptr))
+    {
+      tableHeap->MarkDelete(*rid, nullptr);
+      if(!tableHeap->InsertTuple(newTuple, nullptr))
+      {
+        tableHeap->RollbackDelete(*rid, nullptr);
+        cout << "Error: updated tuple too large for table " << plan_->GetTableName() << endl;
+        return false;
       }
+      tableHeap->ApplyDelete(*rid, nullptr);
     }
+    bool moved = newTuple.GetRowId().Get() != rid->Get();
 
-    tableHeap->MarkDelete(*rid, nullptr);
-    tableHeap->ApplyDelete(*rid, nullptr);
-    tableHeap->InsertTuple(newTuple, nullptr);
+    /* 4. 只更新键被修改的索引，元组移动时所有索引都要指向新的RowId */
+    for(size_t i = 0; i < index_info_.size(); i++)
+    {
+      if(!keyChanged[i] && !moved)
+        continue;
+      index_info_[i]->GetIndex()->RemoveEntry(keys[i].first, *rid, nullptr);
+      index_info_[i]->GetIndex()->InsertEntry(keys[i].second, newTuple.GetRowId(), nullptr);
+    }
 
     return true;
   }
 
+  /* 5. 扫描结束，更新留下的空页足够多时整理表 */
+  tableHeap->AutoVacuum(nullptr);
   return false;
 }
 
-Row UpdateExecutor::GenerateUpdatedTuple(Row src_row) {
-  std::vector<Field *> srcField = src_row.GetFields();
+Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
   std::vector<Field> retField;
   std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs;
   update_attrs = plan_->GetUpdateAttr();
@@ -96,7 +99,7 @@ Row UpdateExecutor::GenerateUpdatedTuple(Row src_row) {
     if (update_attrs.find(i) != plan_->update_attrs_.end())
       retField.push_back(update_attrs[i]->Evaluate(nullptr));
     else
-      retField.push_back(*srcField[i]);
+      retField.emplace_back(*src_row.GetField(i));
   }
 
   return Row(retField);
@@ -0,0 +1,114 @@
+#ifndef MINISQL_BUFFER_POOL_INSTANCE_H
+#define MINISQL_BUFFER_POOL_INSTANCE_H
+
+#include <functional>
+#include <list>
+#include <mutex>
+
+#include "buffer/page_table.h"
+#include "buffer/replacer.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * BufferPoolInstance is one shard of the buffer pool. It owns a fixed set of frames together with its own page
+ * table, free list, replacer and latch, so that pages living in different shards never contend with each other.
+ *
+ * Page ids are handed out by the DiskManager; the owning BufferPoolManager routes every page id to exactly one
+ * instance, so an instance never has to look at pages of another shard.
+ *
+ * FetchPage on a resident page takes no latch: it looks the frame up in the lock-free PageTable and pins it with a
+ * CAS on the pin count, which only succeeds while the count is non-negative. Replacement and deletion run under
+ * latch_ and claim a frame by moving its pin count from 0 to -1, so a frame is never reused under a reader. Because
+ * lock-free hits do not tell the replacer, a frame handed out by Victim may turn out to be pinned; it is then skipped
+ * and re-enters the replacer on its last unpin.
+ *
+ * Frame memory is one PAGE_SIZE aligned block per instance. When the disk manager is read-only the instance owns no
+ * frame memory at all: a fetched page is a view into the mapped file, nothing is ever written back, and NewPage and
+ * FlushPage always fail.
+ */
+class BufferPoolInstance {
+ public:
+  explicit BufferPoolInstance(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type = kLRUReplacer);
+
+  ~BufferPoolInstance();
+
+  Page *FetchPage(page_id_t page_id);
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty);
+
+  bool FlushPage(page_id_t page_id);
+
+  /**
+   * Write back dirty pages in page id order until at most max_dirty_pages of them stay dirty. The pages are pinned
+   * while they are written, so the latch is only held to pick them. The allocation state goes to disk first.
+   * @param max_dirty_pages number of dirty pages allowed to stay in this instance
+   * @param include_pinned whether pinned pages may be written as well, the background writer leaves them alone
+   * @return number of pages written
+   */
+  size_t FlushDirtyPages(size_t max_dirty_pages, bool include_pinned);
+
+  /**
+   * Bring a freshly allocated page into this instance.
+   * @param page_id page id already allocated on disk by the caller
+   * @return the pinned, zeroed page, or nullptr if every frame in this instance is pinned
+   */
+  Page *NewPage(page_id_t page_id);
+
+  /**
+   * Remove the page from this instance. The on-disk page is released by the caller.
+   * @return false if the page is resident and still pinned
+   */
+  bool DeletePage(page_id_t page_id);
+
+  /**
+   * Bring page_id into this instance if it is not resident and let visit inspect it while it is pinned. Unlike
+   * FetchPage + UnpinPage, touching a page that is already resident does not count as an access for the replacer.
+   * @return false if the page could not be brought in because every frame is pinned
+   */
+  bool PrefetchPage(page_id_t page_id, const function<void(Page *)> &visit);
+
+  bool CheckAllUnpinned();
+
+  size_t GetPoolSize() const { return pool_size_; }
+
+ private:
+  /**
+   * Find a frame to hold a new page, from the free list first and then from the replacer. The victim page is
+   * written back if dirty and removed from the page table. Must be called with latch_ held.
+   * @return true if a frame was found
+   */
+  bool TryToFindFreePage(frame_id_t *frame_id);
+
+  /**
+   * Pin a frame found without latch, provided it still holds page_id.
+   * @return false if the frame is being replaced or holds another page
+   */
+  bool TryPinResident(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Drop one pin and hand the frame to the replacer if it was the last one. Must be called with latch_ held.
+   */
+  void UnpinFrame(frame_id_t frame_id);
+
+  /**
+   * Drop one pin taken without latch. If it was the last pin the frame is released to the replacer: a frame that is
+   * still in the replacer keeps its position, one that left it is unpinned.
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+ private:
+  size_t pool_size_;                                 // number of pages in this instance
+  Page *pages_;                                      // array of pages
+  char *frame_data_{nullptr};                        // page data of the frames, unused when read-only
+  DiskManager *disk_manager_;                        // pointer to the disk manager.
+  bool read_only_;                                   // frames are views into the mapped database file
+  PageTable page_table_;                             // to keep track of pages, readable without latch
+  Replacer *replacer_;                               // to find an unpinned page for replacement
+  list<frame_id_t> free_list_;                       // to find a free page for replacement
+  mutex latch_;                                      // to protect shared data structure
+};
+
+#endif  // MINISQL_BUFFER_POOL_INSTANCE_H
@@ -1,20 +1,40 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
-#include <list>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_pool_instance.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * BufferPoolManager is a parallel buffer pool made of num_instances independent BufferPoolInstance shards. A page
+ * with id P always lives in shard P % num_instances, so concurrent sessions only contend on the latch of the shard
+ * that owns the page they touch. With a single instance it behaves exactly like the unsharded pool.
+ *
+ * Over a read-only DiskManager, FetchPage returns views into the mapped database file without copying them, while
+ * NewPage, DeletePage and FlushPage always fail.
+ */
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /**
+   * @param pool_size total number of frames, split evenly among the instances
+   * @param disk_manager disk manager shared by all instances
+   * @param num_instances number of shards
+   * @param replacer_type replacement policy of every shard
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances = 1,
+                             ReplacerType replacer_type = kLRUReplacer);
 
   ~BufferPoolManager();
 
@@ -32,6 +52,37 @@ class BufferPoolManager {
 
   bool CheckAllUnpinned();
 
+  /**
+   * Asynchronously read ahead a chain of pages. A background I/O thread brings page_id into the pool, asks
+   * next_page_id for the successor of the page it just read, and goes on until count pages were visited or
+   * next_page_id returns INVALID_PAGE_ID. Pages already resident are skipped without counting as an access.
+   *
+   * Prefetching is only a hint: requests are dropped when the queue is full or the pool is fully pinned.
+   * @param page_id first page of the chain
+   * @param count maximum number of pages to read ahead
+   * @param next_page_id returns the next page of the chain given a page, nullptr to read a single page
+   */
+  void PrefetchPages(page_id_t page_id, size_t count, function<page_id_t(Page *)> next_page_id = nullptr);
+
+  /**
+   * Write back every dirty page in the pool, pinned or not, e.g. for a checkpoint. The allocation state is written
+   * as well, so the file holds every page allocated before the call.
+   * @return number of pages written
+   */
+  size_t FlushAllPages();
+
+  /**
+   * Set the fraction of dirty frames the background writer aims for. Every flush interval it writes back dirty,
+   * unpinned pages in page id order until each instance is at or below the target. A ratio of 1 disables it.
+   */
+  void SetDirtyRatioTarget(double dirty_ratio) { dirty_ratio_target_ = dirty_ratio; }
+
+  double GetDirtyRatioTarget() const { return dirty_ratio_target_; }
+
+  size_t GetPoolSize() const { return pool_size_; }
+
+  size_t GetNumInstances() const { return instances_.size(); }
+
  private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
@@ -43,16 +94,38 @@ class BufferPoolManager {
    */
   void DeallocatePage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
+  /**
+   * Body of the background I/O thread, serves prefetch requests until the buffer pool is destroyed.
+   */
+  void PrefetchWorker();
+
+  /**
+   * Body of the background writer thread, keeps the dirty ratio under target until the buffer pool is destroyed.
+   */
+  void FlushWorker();
+
+  /** @return the shard responsible for page_id */
+  inline BufferPoolInstance *GetInstance(page_id_t page_id) { return instances_[page_id % instances_.size()]; }
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  size_t pool_size_;                         // number of pages in buffer pool
+  DiskManager *disk_manager_;                // pointer to the disk manager.
+  vector<BufferPoolInstance *> instances_;   // shards, indexed by page_id % num_instances
+
+  struct PrefetchRequest {
+    page_id_t page_id;
+    size_t count;
+    function<page_id_t(Page *)> next_page_id;
+  };
+  static constexpr size_t MAX_PREFETCH_REQUESTS = 64;
+  deque<PrefetchRequest> prefetch_queue_;    // pending read-ahead requests
+  atomic<double> dirty_ratio_target_{DIRTY_RATIO_TARGET};  // dirty frames the background writer aims for
+  mutex background_latch_;                   // to protect prefetch_queue_ and stop_background_
+  condition_variable prefetch_cv_;           // to wake up the I/O thread
+  condition_variable flush_cv_;              // to wake up the background writer
+  bool stop_background_{false};
+  thread prefetch_thread_;                   // background I/O thread serving read-ahead
+  thread flush_thread_;                      // background writer of dirty pages
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
@@ -1,12 +1,6 @@
 #ifndef MINISQL_CLOCK_REPLACER_H
 #define MINISQL_CLOCK_REPLACER_H
 
-#include <algorithm>
-#include <list>
-#include <map>
-#include <mutex>
-#include <queue>
-#include <unordered_set>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -16,6 +10,10 @@ using namespace std;
 
 /**
  * CLOCKReplacer implements the clock replacement.
+ *
+ * Frames are arranged in a circle indexed by frame id. Each frame has a flag telling whether it can be victimized
+ * and a reference bit that is set on every Unpin. Victim sweeps the clock hand over the circle, clearing reference
+ * bits, and evicts the first evictable frame whose bit is already clear.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -36,12 +34,18 @@ class CLOCKReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Release(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
   size_t Size() override;
 
  private:
   size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  size_t size{0};             // replacer中可以被替换的数据页数
+  size_t clock_hand{0};       // 时钟指针
+  vector<char> evictable;     // 数据页是否可以被替换
+  vector<char> reference;     // 数据页的引用位
 };
 
-#endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
+#endif  // MINISQL_CLOCK_REPLACER_H
@@ -0,0 +1,66 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * Every Unpin of a frame counts as one access. The backward k-distance of a frame is the time since its k-th most
+ * recent access, and Victim evicts the evictable frame with the largest one. Frames with fewer than k accesses have
+ * an infinite distance and go first, oldest first access first. A page read once by a sequential scan therefore
+ * leaves the pool before an index page that is accessed again and again.
+ *
+ * The access history of a frame is dropped when it is victimized or removed.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of accesses to remember per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  using Candidate = std::pair<size_t, frame_id_t>;  // <eviction key, frame>
+
+  /** @return the oldest remembered access: the first one below k accesses, the k-th most recent one otherwise */
+  size_t EvictionKey(frame_id_t frame_id) const;
+
+  /** @return the candidate set frame_id belongs to */
+  std::set<Candidate> &CandidateSet(frame_id_t frame_id) {
+    return access_count_[frame_id] < k_ ? history_set_ : cache_set_;
+  }
+
+ private:
+  size_t k_;
+  size_t current_timestamp_{0};
+  std::vector<size_t> history_;       // k timestamps per frame, used as a ring buffer
+  std::vector<size_t> access_count_;  // number of recorded accesses per frame
+  std::vector<char> evictable_;       // whether the frame is in one of the candidate sets
+  std::set<Candidate> history_set_;   // evictable frames with less than k accesses
+  std::set<Candidate> cache_set_;     // evictable frames with at least k accesses
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
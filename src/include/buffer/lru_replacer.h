@@ -1,9 +1,7 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
 #include <mutex>
-#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -11,6 +9,9 @@
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * The LRU list is intrusive: every frame owns a prev/next slot in two arrays preallocated for num_pages frames, and
+ * slot num_pages is the sentinel head of the circular list. Victim, Pin and Unpin are O(1) and never allocate.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -34,11 +35,21 @@ class LRUReplacer : public Replacer {
   size_t Size() override;
 
 private:
-  // add your own private member variables here
-  std::list<frame_id_t> lru_list_;
-  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lru_table_;
-  std::recursive_mutex latch_;
+  /** @return true if frame_id is linked into the LRU list */
+  inline bool IsLinked(frame_id_t frame_id) const { return next_[frame_id] != INVALID_FRAME_ID; }
 
+  /** Unlink frame_id from the LRU list. */
+  void Unlink(frame_id_t frame_id);
+
+  /** Link frame_id at the most recently used end of the LRU list. */
+  void PushBack(frame_id_t frame_id);
+
+private:
+  frame_id_t head_;                 // sentinel, next_[head_] is the least recently used frame
+  std::vector<frame_id_t> prev_;    // prev_[i]: previous frame of frame i, INVALID_FRAME_ID if unlinked
+  std::vector<frame_id_t> next_;    // next_[i]: next frame of frame i, INVALID_FRAME_ID if unlinked
+  size_t size_{0};
+  std::mutex latch_;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
@@ -0,0 +1,89 @@
+#ifndef MINISQL_PAGE_TABLE_H
+#define MINISQL_PAGE_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * PageTable maps resident page ids to frame ids of one buffer pool instance.
+ *
+ * It is an open-addressing hash table with linear probing whose capacity is fixed at construction (a power of two
+ * at least twice the number of frames), so it never rehashes. Every slot packs <page_id, frame_id> into one 64-bit
+ * atomic word, which lets Find run without any lock.
+ *
+ * Insert and Erase must be serialized by the caller (the instance latch). Erase uses backward-shift deletion, so
+ * no tombstones pile up; the price is that a concurrent Find may miss an entry that is being shifted. Readers
+ * therefore treat Find as a hint: a hit is validated against the frame, and a miss falls back to the latched path.
+ */
+class PageTable {
+ public:
+  /**
+   * @param num_frames the maximum number of entries the table will hold
+   */
+  explicit PageTable(size_t num_frames);
+
+  ~PageTable() = default;
+
+  DISALLOW_COPY(PageTable)
+
+  /**
+   * Lock-free lookup.
+   * @return true and set frame_id if page_id was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Insert or overwrite the mapping of page_id. Caller must hold the writer latch.
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove the mapping of page_id. Caller must hold the writer latch.
+   * @return false if page_id was not in the table
+   */
+  bool Erase(page_id_t page_id);
+
+  /** @return number of entries, only exact while holding the writer latch */
+  size_t Size() const { return size_; }
+
+  /**
+   * Visit every entry. Caller must hold the writer latch.
+   */
+  template <typename Func>
+  void ForEach(Func &&func) const {
+    for (size_t i = 0; i < capacity_; i++) {
+      uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot != EMPTY_SLOT) {
+        func(SlotPageId(slot), SlotFrameId(slot));
+      }
+    }
+  }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = UINT64_MAX;
+
+  static inline uint64_t MakeSlot(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static inline page_id_t SlotPageId(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static inline frame_id_t SlotFrameId(uint64_t slot) { return static_cast<frame_id_t>(slot & UINT32_MAX); }
+
+  /** Home slot of page_id. Page ids of one instance share a residue, so mix the bits before masking. */
+  inline size_t HomeSlot(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                               shift_);
+  }
+
+ private:
+  size_t capacity_;
+  size_t mask_;
+  uint32_t shift_;
+  size_t size_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+#endif  // MINISQL_PAGE_TABLE_H
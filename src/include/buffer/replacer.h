@@ -5,6 +5,15 @@
 
 #include "common/config.h"
 
+/**
+ * Replacement policies a buffer pool can be built with.
+ */
+enum ReplacerType {
+  kLRUReplacer = 0,  // least recently used
+  kClockReplacer,    // second chance, approximates LRU with one reference bit per frame
+  kLRUKReplacer,     // backward k-distance, a page touched once by a scan is evicted before hot pages
+};
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,6 +42,19 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Hands a frame back without counting it as an access: a frame still in the replacer keeps its position, a frame
+   * that has left it is unpinned.
+   * @param frame_id the id of the frame to release
+   */
+  virtual void Release(frame_id_t frame_id) { Unpin(frame_id); }
+
+  /**
+   * Removes a frame whose page was deleted, together with any access history kept for it.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -84,9 +84,17 @@ class IndexInfo {
 
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  static constexpr size_t MAX_ENCODED_KEY_SIZE = 504;  // longest encoded key, the largest key size is 512
+
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, key_schema_{nullptr} {}
 
+  /**
+   * The encoded key is rounded up to a key size of 16 to 512 bytes, longer keys are not supported. A char(n) column takes n + 3 bytes, an int or float column 5, and a key of a non-unique index
+   * ends with the 8 byte row id, so the longest char column that can be indexed alone is char(501) in a unique
+   * index and char(493) otherwise.
+   * @return the index, nullptr if its key is too large or index_type is unknown
+   */
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type);
 
  private:
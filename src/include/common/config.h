@@ -15,9 +15,20 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index
 
 static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 8;  // default number of buffer pool shards
+static constexpr int LRUK_REPLACER_K = 2;               // k of the LRU-K replacer
+static constexpr int TABLE_PREFETCH_WINDOW = 8;         // pages read ahead by a sequential table scan
+static constexpr double DIRTY_RATIO_TARGET = 0.2;       // fraction of dirty frames the background writer keeps
+static constexpr int FLUSH_INTERVAL_MS = 100;           // period of the background writer in milliseconds
+static constexpr int DISK_IO_THREADS = 4;               // number of asynchronous disk I/O workers
+static constexpr int INSERT_BATCH_SIZE = 1024;          // rows an INSERT hands to the table heap at once
+static constexpr int AUTOVACUUM_EMPTY_PAGES = 16;       // pages emptied by deletes before a table is vacuumed
+static constexpr int SCAN_WORKER_THREADS = 4;           // workers of a parallel sequential scan
+static constexpr int SCAN_MORSEL_PAGES = 16;            // pages a parallel scan worker takes at a time
+static constexpr int OVERFLOW_FIELD_SIZE = PAGE_SIZE / 4;  // char fields longer than this go to overflow pages
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
-static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
+static constexpr uint32_t VARCHAR_MAX_LEN = 16 * PAGE_SIZE;  // max length of varchar
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
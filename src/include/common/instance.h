@@ -14,7 +14,17 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param replacer_type eviction policy of the buffer pool. LRU stays the default: the LRU-K replacer keeps its
+   *                      history in a std::set and allocates on every Pin and Unpin.
+   * @param read_only open an existing database without ever writing to it. The database file is memory mapped and
+   *                  pages are served straight from the mapping, init must be false.
+   * @param checksums keep a CRC32 per page next to the database file and refuse pages that fail it. A database that
+   *                  already has checksums keeps them whatever is passed here.
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                           ReplacerType replacer_type = kLRUReplacer, bool read_only = false, bool checksums = false);
 
   ~DBStorageEngine();
 
@@ -26,6 +36,7 @@ class DBStorageEngine {
   CatalogManager *catalog_mgr_;
   std::string db_file_name_;
   bool init_;
+  bool read_only_;
 };
 
 #endif  // MINISQL_INSTANCE_H
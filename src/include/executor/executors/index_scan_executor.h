@@ -39,4 +39,5 @@ class IndexScanExecutor : public AbstractExecutor {
   /** The sequential scan plan node to be executed */
   const IndexScanPlanNode *plan_;
   std::vector<RowId> list;
+  size_t cursor_{0};  // next row of list to return
 };
\ No newline at end of file
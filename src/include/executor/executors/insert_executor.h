@@ -12,7 +12,8 @@
 /**
  * InsertExecutor executes an insert on a table.
  *
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor, INSERT_BATCH_SIZE rows at a time. Every batch is checked
+ * against the unique indexes as a whole, handed to the table heap at once and added to the indexes in key order.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -41,10 +42,22 @@ class InsertExecutor : public AbstractExecutor {
   /** @return The output schema for the insert */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
+ private:
+  /**
+   * Pull the next batch from the child and insert it. On a unique key violation only the rows before the violating
+   * one are inserted and the insert stops.
+   */
+  void InsertBatch();
+
  private:
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  TableInfo *table_info_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+  std::vector<Row> batch_;  // rows of the current batch that were inserted
+  size_t cursor_{0};        // next row of batch_ to return
+  bool finished_{false};    // no batch follows the current one
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
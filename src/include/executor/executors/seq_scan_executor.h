@@ -5,14 +5,24 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "storage/table_scan_cursor.h"
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * A scan whose plan allows it and whose table spans more than one morsel of SCAN_MORSEL_PAGES pages runs in parallel:
+ * SCAN_WORKER_THREADS workers claim morsels in heap order, filter and materialize their rows, and Next hands the rows
+ * out morsel by morsel, so the output keeps the order of a serial scan. Workers stay at most a few morsels ahead of
+ * Next, which bounds the rows buffered at a time.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -23,6 +33,8 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  ~SeqScanExecutor() override { StopWorkers(); }
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -41,9 +53,42 @@ class SeqScanExecutor : public AbstractExecutor {
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
 
-  TableIterator tableIt;
+  /** Filter the rows of the current page and copy out the next match, nullptr filter passes every row */
+  bool NextMatch(TableScanCursor *cursor, Row *row);
+
+  /** Worker loop of a parallel scan, scans claimed morsels until none are left */
+  void ScanMorsels(TableHeap *table_heap);
+
+  /** Stop and join the workers of a parallel scan, if any */
+  void StopWorkers();
+
+  /** Columns of the table read by the output and the predicate, the only ones decoded */
+  std::unique_ptr<RowProjection> projection_;
+
+  /** Cursor over the table, keeps the page of the current row pinned, nullptr for a parallel scan */
+  std::unique_ptr<TableScanCursor> cursor_;
+
+  /** Page ranges of a parallel scan, in heap order */
+  std::vector<std::vector<page_id_t>> morsels_;
+
+  /** Matching rows of every morsel, valid once the morsel is done */
+  std::vector<std::vector<Row>> morsel_rows_;
+  std::vector<bool> morsel_done_;
+
+  /** Next morsel for a worker to claim, and next morsel for Next to hand out */
+  size_t next_morsel_{0};
+  size_t next_output_{0};
+  bool stopping_{false};
+
+  /** Rows of the morsel Next is handing out */
+  std::vector<Row> output_rows_;
+  size_t output_pos_{0};
+
+  std::vector<std::thread> workers_;
 
-  TableIterator end;
+  /** Protects the morsel state above, which is shared with the workers */
+  std::mutex latch_;
+  std::condition_variable cv_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
@@ -49,11 +49,13 @@ class UpdateExecutor : public AbstractExecutor {
    * based on the `UpdateInfo` provided in the plan.
    * @param src_row The row to be updated
    */
-  Row GenerateUpdatedTuple(Row src_row);
+  Row GenerateUpdatedTuple(const Row &src_row);
 
   /** The update plan node to be executed */
   const UpdatePlanNode *plan_;
   /** Metadata identifying the table that should be updated */
+  TableInfo *table_info_{nullptr};
+  /** The indexes of the table */
   std::vector<IndexInfo *> index_info_;
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
@@ -5,9 +5,13 @@
 #ifndef MINISQL_SEQ_SCAN_PLAN_H
 #define MINISQL_SEQ_SCAN_PLAN_H
 
+#include <algorithm>
+#include <vector>
+
 #include "abstract_plan.h"
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
+#include "planner/expressions/column_value_expression.h"
 
 class SeqScanPlanNode : public AbstractPlanNode {
  public:
@@ -19,7 +23,18 @@ class SeqScanPlanNode : public AbstractPlanNode {
   SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr)
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)) {
+    for (auto column : output->GetColumns(0)) {
+      output_columns_.push_back(column->GetTableInd());
+    }
+    referenced_columns_ = output_columns_;
+    if (filter_predicate_ != nullptr) {
+      CollectColumns(filter_predicate_.get(), referenced_columns_);
+    }
+    std::sort(referenced_columns_.begin(), referenced_columns_.end());
+    referenced_columns_.erase(std::unique(referenced_columns_.begin(), referenced_columns_.end()),
+                              referenced_columns_.end());
+  }
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::SeqScan; }
@@ -29,11 +44,45 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  /** @return The table column of each output column, in output order */
+  const std::vector<uint32_t> &GetOutputColumns() const { return output_columns_; }
+
+  /** @return The table columns read by the output and the predicate, in table order */
+  const std::vector<uint32_t> &GetReferencedColumns() const { return referenced_columns_; }
+
+  /**
+   * Let the scan split the table into page ranges and filter them on several threads. Only safe for read-only
+   * statements, a delete or update modifies the table while it is scanned.
+   */
+  void SetParallel(bool parallel) { parallel_ = parallel; }
+
+  /** @return Whether the scan may run on several threads */
+  bool IsParallel() const { return parallel_; }
+
   /** The table name */
   std::string table_name_;
 
   /** The predicate to filter in SeqScan.*/
   AbstractExpressionRef filter_predicate_;
+
+ private:
+  static void CollectColumns(AbstractExpression *expr, std::vector<uint32_t> &columns) {
+    if (expr->GetType() == ExpressionType::ColumnExpression) {
+      columns.push_back(static_cast<ColumnValueExpression *>(expr)->GetColIdx());
+    }
+    for (const auto &child : expr->GetChildren()) {
+      CollectColumns(child.get(), columns);
+    }
+  }
+
+  /** Table column of each output column */
+  std::vector<uint32_t> output_columns_;
+
+  /** Table columns the scan has to decode */
+  std::vector<uint32_t> referenced_columns_;
+
+  /** Whether the scan may run on several threads */
+  bool parallel_{false};
 };
 
 #endif  // MINISQL_SEQ_SCAN_PLAN_H
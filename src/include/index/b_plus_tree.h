@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
@@ -39,7 +40,7 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // return the value associated with a given key, every value of the key for a non-unique index
   bool GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction = nullptr);
 
   IndexIterator Begin();
@@ -63,12 +64,14 @@ class BPlusTree {
     }
     out << "digraph G {" << std::endl;
     Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    auto *node = reinterpret_cast<BPlusTreePage *>(root_page);
+    auto *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
     ToGraph(node, buffer_pool_manager_, out);
     out << "}" << std::endl;
   }
 
  private:
+  bool GetValues(const GenericKey *key, std::vector<RowId> &result);
+
   void StartNewTree(GenericKey *key, const RowId &value);
 
   bool InsertIntoLeaf(GenericKey *key, RowId &value, Transaction *transaction = nullptr);
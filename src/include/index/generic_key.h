@@ -1,16 +1,80 @@
 #ifndef MINISQL_GENERIC_KEY_H
 #define MINISQL_GENERIC_KEY_H
 
+#include <algorithm>
 #include <cstring>
 
 #include "record/field.h"
 #include "record/row.h"
 
+/**
+ * GenericKey holds a key in an order-preserving binary encoding, so two keys of the same schema compare with a single
+ * memcmp. Every column takes a fixed number of bytes:
+ * -------------------------------------------
+ * | Null byte | Value |
+ * -------------------------------------------
+ *  The null byte is 0 for null, which orders before any value, and 1 otherwise. The value of a null column is zeros.
+ *  - int: big-endian with the sign bit flipped
+ *  - float: big-endian IEEE bits, all bits flipped for negative numbers and the sign bit flipped otherwise
+ *  - char: the data padded with zeros to the column length, followed by the big-endian uint16 data length
+ *
+ *  The key of a non-unique index is followed by the RowId of its row, the page id with the sign bit flipped and the
+ *  slot number, both big-endian, so entries of equal keys are unique and ordered by RowId. A key serialized without
+ *  RowId has zeros there and orders before all entries of the same key.
+ */
 class GenericKey {
   friend class KeyManager;
+
+  friend class MemcmpKeyComparator;
+
+  template <typename T>
+  friend class FixedKeyComparator;
+
   char data[0];
 };
 
+/**
+ * Compares keys of any schema byte by byte.
+ */
+class MemcmpKeyComparator {
+ public:
+  explicit MemcmpKeyComparator(uint32_t size) : size_(size) {}
+
+  inline int operator()(const GenericKey *lhs, const GenericKey *rhs) const {
+    int ret = memcmp(lhs->data, rhs->data, size_);
+    return (ret > 0) - (ret < 0);
+  }
+
+ private:
+  uint32_t size_;
+};
+
+/**
+ * Compares keys whose encoding fits in an unsigned T, e.g. a single int or float column in uint64_t, as one
+ * big-endian integer. The bytes after the encoding are zeros in every key, so they do not change the order.
+ */
+template <typename T>
+class FixedKeyComparator {
+ public:
+  inline int operator()(const GenericKey *lhs, const GenericKey *rhs) const {
+    T l = Load(lhs->data), r = Load(rhs->data);
+    return (l > r) - (l < r);
+  }
+
+  static inline T Load(const char *buf) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, buf + i, sizeof(word));
+      value = (value << 32 << 32) | __builtin_bswap64(word);
+    }
+    return value;
+  }
+};
+
+using WordKeyComparator = FixedKeyComparator<uint64_t>;
+using DoubleWordKeyComparator = FixedKeyComparator<unsigned __int128>;
+
 class KeyManager {
  public: /**/
   [[nodiscard]] inline GenericKey *InitKey() const {
@@ -19,41 +83,99 @@ class KeyManager {
 
   inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
     // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
+    ASSERT(GetEncodedSize(schema, unique_) <= (uint32_t)key_size_, "Index key size exceed max key size.");
     memset(key_buf->data, 0, key_size_);
-    key.SerializeTo(key_buf->data, schema);
+    char *buf = key_buf->data;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const Column *column = schema->GetColumn(i);
+      const Field *field = key.GetField(i);
+      if (!field->IsNull()) {
+        buf[0] = 1;
+        EncodeField(*field, column->GetLength(), buf + 1);
+      }
+      buf += GetEncodedSize(column);
+    }
+  }
+
+  /**
+   * Serialize the key of the entry of row rid, which is part of the key if the index is not unique
+   */
+  inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema, RowId rid) const {
+    SerializeFromKey(key_buf, key, schema);
+    if (!unique_) {
+      char *buf = key_buf->data + encoded_size_ - SIZE_ROW_ID;
+      WriteBigEndian<uint32_t>(buf, static_cast<uint32_t>(rid.GetPageId()) ^ (1U << 31));
+      WriteBigEndian<uint32_t>(buf + sizeof(uint32_t), rid.GetSlotNum());
+    }
   }
 
   inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
-    ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
+    /* 1. 先求出字符串总长，整个键只分配一块行缓冲 */
+    uint32_t varlen_size = 0;
+    const char *buf = key_buf->data;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const Column *column = schema->GetColumn(i);
+      if (buf[0] && column->GetType() == TypeId::kTypeChar) {
+        varlen_size += ReadBigEndian<uint16_t>(buf + 1 + column->GetLength());
+      }
+      buf += GetEncodedSize(column);
+    }
+
+    /* 2. 逐列解码 */
+    key.Init(schema->GetColumnCount(), varlen_size);
+    buf = key_buf->data;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const Column *column = schema->GetColumn(i);
+      if (buf[0]) {
+        key.SetField(i, DecodeField(column, buf + 1));
+      } else {
+        key.SetField(i, Field(column->GetType()));
+      }
+      buf += GetEncodedSize(column);
+    }
   }
 
   // compare
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-    //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-    uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
-      }
+    return MemcmpKeyComparator(encoded_size_)(lhs, rhs);
+  }
 
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
-      }
+  /**
+   * Compare the columns of two keys only, leaving out the RowId of a non-unique index
+   */
+  [[nodiscard]] inline int CompareColumns(const GenericKey *lhs, const GenericKey *rhs) const {
+    return MemcmpKeyComparator(unique_ ? encoded_size_ : encoded_size_ - SIZE_ROW_ID)(lhs, rhs);
+  }
+
+  inline bool IsUnique() const { return unique_; }
+
+  /**
+   * Call func with the comparator specialized for the keys of this index, chosen once when the index is created:
+   * keys encoded in at most 8 or 16 bytes compare as one integer, any other key with memcmp.
+   * @return the result of func
+   */
+  template <typename Func>
+  inline auto WithComparator(Func &&func) const {
+    switch (layout_) {
+      case KeyLayout::kWord:
+        return func(WordKeyComparator());
+      case KeyLayout::kDoubleWord:
+        return func(DoubleWordKeyComparator());
+      default:
+        return func(MemcmpKeyComparator(encoded_size_));
+    }
+  }
+
+  /**
+   * @return bytes a key of schema takes in the encoding, the key size of an index must be at least this
+   */
+  static inline uint32_t GetEncodedSize(const Schema *schema, bool unique = true) {
+    uint32_t size = unique ? 0 : SIZE_ROW_ID;
+    for (auto column : schema->GetColumns(0)) {
+      size += GetEncodedSize(column);
     }
-    // equals
-    return 0;
+    return size;
   }
 
   inline int GetKeySize() const { return key_size_; }
@@ -61,14 +183,97 @@ class KeyManager {
   KeyManager(const KeyManager &other) {
     this->key_schema_ = other.key_schema_;
     this->key_size_ = other.key_size_;
+    this->encoded_size_ = other.encoded_size_;
+    this->unique_ = other.unique_;
+    this->layout_ = other.layout_;
   }
 
   // constructor
-  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+  KeyManager(Schema *key_schema, size_t key_size, bool unique = true)
+      : key_size_(key_size),
+        key_schema_(key_schema),
+        encoded_size_(GetEncodedSize(key_schema, unique)),
+        unique_(unique) {
+    ASSERT(encoded_size_ <= (uint32_t)key_size_, "Index key size exceed max key size.");
+    if (encoded_size_ <= sizeof(uint64_t) && key_size >= sizeof(uint64_t)) {
+      layout_ = KeyLayout::kWord;
+    } else if (encoded_size_ <= sizeof(unsigned __int128) && key_size >= sizeof(unsigned __int128)) {
+      layout_ = KeyLayout::kDoubleWord;
+    }
+  }
 
  private:
+  static constexpr uint32_t SIZE_ROW_ID = sizeof(uint32_t) + sizeof(uint32_t);
+
+  enum class KeyLayout { kGeneric, kWord, kDoubleWord };
+
+  static inline uint32_t GetEncodedSize(const Column *column) {
+    uint32_t size = sizeof(uint8_t) + column->GetLength();
+    return column->GetType() == TypeId::kTypeChar ? size + sizeof(uint16_t) : size;
+  }
+
+  template <typename T>
+  static inline void WriteBigEndian(char *buf, T value) {
+    for (int i = sizeof(T) - 1; i >= 0; i--) {
+      buf[i] = static_cast<char>(value & 0xff);
+      value >>= 8;
+    }
+  }
+
+  template <typename T>
+  static inline T ReadBigEndian(const char *buf) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      value = (value << 8) | static_cast<uint8_t>(buf[i]);
+    }
+    return value;
+  }
+
+  static inline void EncodeField(const Field &field, uint32_t length, char *buf) {
+    switch (field.GetTypeId()) {
+      case TypeId::kTypeInt:
+        WriteBigEndian<uint32_t>(buf, static_cast<uint32_t>(field.value_.integer_) ^ (1U << 31));
+        break;
+      case TypeId::kTypeFloat: {
+        /* -0.0与0.0相等，先统一为0.0 */
+        float value = field.value_.float_;
+        uint32_t bits;
+        value = value == 0.0f ? 0.0f : value;
+        memcpy(&bits, &value, sizeof(bits));
+        WriteBigEndian<uint32_t>(buf, (bits & (1U << 31)) ? ~bits : bits | (1U << 31));
+        break;
+      }
+      default: {
+        /* 超出列长的字符串本就不合模式，只保留列长以内的部分 */
+        uint32_t len = std::min(field.GetLength(), length);
+        memcpy(buf, field.GetData(), len);
+        WriteBigEndian<uint16_t>(buf + length, len);
+      }
+    }
+  }
+
+  static inline Field DecodeField(const Column *column, const char *buf) {
+    switch (column->GetType()) {
+      case TypeId::kTypeInt:
+        return Field(TypeId::kTypeInt, static_cast<int32_t>(ReadBigEndian<uint32_t>(buf) ^ (1U << 31)));
+      case TypeId::kTypeFloat: {
+        uint32_t bits = ReadBigEndian<uint32_t>(buf);
+        bits = (bits & (1U << 31)) ? bits & ~(1U << 31) : ~bits;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return Field(TypeId::kTypeFloat, value);
+      }
+      default:
+        return Field(TypeId::kTypeChar, const_cast<char *>(buf), ReadBigEndian<uint16_t>(buf + column->GetLength()),
+                     false);
+    }
+  }
+
   int key_size_;
   Schema *key_schema_;
+  uint32_t encoded_size_; /** bytes of a key compared, the rest of key_size_ is zeros */
+  KeyLayout layout_{KeyLayout::kGeneric};
+  bool unique_{true}; /** false if the keys are followed by the RowId of their entry */
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
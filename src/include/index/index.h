@@ -22,6 +22,9 @@ class Index {
 
   virtual dberr_t Destroy() = 0;
 
+  /** @return false if several rows may have the same key */
+  virtual bool IsUnique() const = 0;
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
@@ -0,0 +1,99 @@
+#ifndef MINISQL_KEY_SEARCH_H
+#define MINISQL_KEY_SEARCH_H
+
+#include <cstdint>
+
+#include "index/generic_key.h"
+
+/**
+ * KeySearch finds a key among the sorted keys of a B+ tree page, stored stride bytes apart.
+ *
+ * The range is narrowed without branches on the comparison results until at most LINEAR_SEARCH_SIZE keys are
+ * left, which are then counted in one pass instead of more mispredicted binary search steps. For keys compared as
+ * one word (a single int or float column) the last pass runs on an AVX2 or SSE4.2 kernel, picked once via CPUID,
+ * with a scalar fallback.
+ */
+class KeySearch {
+ public:
+  /** Counts the keys of n keys stride bytes apart whose big-endian leading word is less than probe */
+  using CountLessFunc = int (*)(const char *keys, int stride, int n, uint64_t probe);
+
+  /**
+   * @return index of the first of n keys not less than key, n if there is none
+   */
+  template <typename Comparator>
+  static inline int LowerBound(const char *keys, int stride, int n, const GenericKey *key,
+                               const Comparator &comparator) {
+    int first = Narrow<false>(keys, stride, n, key, comparator);
+    int count = 0;
+    for (int i = first; i < first + n; i++) {
+      count += comparator(reinterpret_cast<const GenericKey *>(keys + i * stride), key) < 0;
+    }
+    return first + count;
+  }
+
+  /**
+   * @return index of the first of n keys greater than key, n if there is none
+   */
+  template <typename Comparator>
+  static inline int UpperBound(const char *keys, int stride, int n, const GenericKey *key,
+                               const Comparator &comparator) {
+    int first = Narrow<true>(keys, stride, n, key, comparator);
+    int count = 0;
+    for (int i = first; i < first + n; i++) {
+      count += comparator(reinterpret_cast<const GenericKey *>(keys + i * stride), key) <= 0;
+    }
+    return first + count;
+  }
+
+  static inline int LowerBound(const char *keys, int stride, int n, const GenericKey *key,
+                               const WordKeyComparator &comparator) {
+    int first = Narrow<false>(keys, stride, n, key, comparator);
+    return first + count_less_(keys + first * stride, stride, n, Probe(key));
+  }
+
+  static inline int UpperBound(const char *keys, int stride, int n, const GenericKey *key,
+                               const WordKeyComparator &comparator) {
+    /* 编码后的首字节是空值标志，探测字不会是全1，加1不会溢出 */
+    int first = Narrow<true>(keys, stride, n, key, comparator);
+    return first + count_less_(keys + first * stride, stride, n, Probe(key) + 1);
+  }
+
+  /** @return name of the kernel used for word keys: "avx2", "sse4.2" or "scalar" */
+  static const char *GetKernelName();
+
+  static int CountLessScalar(const char *keys, int stride, int n, uint64_t probe);
+
+  static int CountLessSse42(const char *keys, int stride, int n, uint64_t probe);
+
+  static int CountLessAvx2(const char *keys, int stride, int n, uint64_t probe);
+
+  static constexpr int LINEAR_SEARCH_SIZE = 16;
+
+ private:
+  /**
+   * Narrow n keys down to at most LINEAR_SEARCH_SIZE, the bound searched is first + the count of keys before it among
+   * the n keys left.
+   * @param upper true to search for the first key greater than key, false for the first key not less than it
+   * @return index of the first key left
+   */
+  template <bool upper, typename Comparator>
+  static inline int Narrow(const char *keys, int stride, int &n, const GenericKey *key, const Comparator &comparator) {
+    int first = 0;
+    while (n > LINEAR_SEARCH_SIZE) {
+      int half = n / 2;
+      int cmp = comparator(reinterpret_cast<const GenericKey *>(keys + (first + half) * stride), key);
+      first = (upper ? cmp <= 0 : cmp < 0) ? first + half : first;
+      n -= half;
+    }
+    return first;
+  }
+
+  static inline uint64_t Probe(const GenericKey *key) {
+    return WordKeyComparator::Load(reinterpret_cast<const char *>(key));
+  }
+
+  static CountLessFunc count_less_;
+};
+
+#endif  // MINISQL_KEY_SEARCH_H
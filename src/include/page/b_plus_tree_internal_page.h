@@ -64,6 +64,9 @@ class BPlusTreeInternalPage : public BPlusTreePage {
                          BufferPoolManager *buffer_pool_manager);
 
  private:
+  template <typename Comparator>
+  page_id_t Lookup(const GenericKey *key, const Comparator &comparator);
+
   void CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager);
 
   void CopyLastFrom(GenericKey *key, page_id_t value, BufferPoolManager *buffer_pool_manager);
@@ -6,7 +6,8 @@
  *
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys of a non-unique index are made unique by the RowId appended to
+ * them, see include/index/generic_key.h.
 
  * Leaf page format (keys are stored in order):
  *  ----------------------------------------------------------------------
@@ -75,6 +76,9 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
+  template <typename Comparator>
+  int KeyIndex(const GenericKey *key, const Comparator &comparator);
+
   void CopyNFrom(void *src, int size);
 
   void CopyLastFrom(GenericKey *key, const RowId value);
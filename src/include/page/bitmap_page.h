@@ -40,6 +40,14 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * Find the first free page at or after start, wrapping around to the beginning of the extent. The bitmap is
+   * scanned a 64-bit word at a time.
+   *
+   * @return offset of the free page, GetMaxSupportedSize() if the extent is full
+   */
+  uint32_t FindFreePage(uint32_t start) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
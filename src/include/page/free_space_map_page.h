@@ -0,0 +1,72 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <utility>
+
+#include "common/config.h"
+
+/**
+ * A free space map page records how much free space the pages of one table heap have. The free space map of a heap
+ * is a chain of such pages, whose entries follow the order of the table pages in the heap.
+ *
+ * Free space is kept in NUM_BUCKETS buckets of BUCKET_SIZE bytes, rounded down, so a page in bucket b has at least
+ * b * BUCKET_SIZE free bytes.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | Page_1 id (4) | Page_1 bucket (4) | ... |
+ *  ----------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t NUM_BUCKETS = 32;
+  static constexpr uint32_t BUCKET_SIZE = PAGE_SIZE / NUM_BUCKETS;
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - 8) / 8;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetEntryCount() const { return count_; }
+
+  bool IsFull() const { return count_ >= MAX_ENTRY_COUNT; }
+
+  page_id_t PageIdAt(uint32_t index) const { return entries_[index].first; }
+
+  uint32_t BucketAt(uint32_t index) const { return entries_[index].second; }
+
+  void SetBucketAt(uint32_t index, uint32_t bucket) { entries_[index].second = bucket; }
+
+  /**
+   * @return index of the new entry, the page must not be full
+   */
+  uint32_t Append(page_id_t page_id, uint32_t bucket) {
+    entries_[count_].first = page_id;
+    entries_[count_].second = bucket;
+    return count_++;
+  }
+
+  /** @return the bucket of a page with free_space free bytes */
+  static uint32_t BucketOf(uint32_t free_space) {
+    uint32_t bucket = free_space / BUCKET_SIZE;
+    return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1;
+  }
+
+  /** @return the lowest bucket whose pages surely have size free bytes, NUM_BUCKETS if there is none */
+  static uint32_t BucketFor(uint32_t size) {
+    uint32_t bucket = (size + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS;
+  }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  std::pair<page_id_t, uint32_t> entries_[0];
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
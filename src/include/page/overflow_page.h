@@ -0,0 +1,41 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+
+#include "common/config.h"
+
+/**
+ * An overflow page holds a piece of a char field too long to be kept inside its table page. The field is spread over
+ * a chain of such pages, the row only keeps the id of the first one.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------
+ * | NextPageId (4) | DataSize (4) | ... Data ... |
+ *  ---------------------------------------------------------
+ */
+class OverflowPage {
+ public:
+  static constexpr uint32_t SIZE_HEADER = 8;
+  static constexpr uint32_t MAX_DATA_SIZE = PAGE_SIZE - SIZE_HEADER;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    size_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetDataSize() const { return size_; }
+
+  void SetDataSize(uint32_t size) { size_ = size; }
+
+  char *GetPageData() { return data_; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[0];
+};
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
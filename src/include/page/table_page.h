@@ -12,9 +12,16 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------------------
+ *  | TupleCount (2) | Format (2) | LiveSlots (64) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ---------------------------------------------------------------------------------------------------------
+ *
+ *  LiveSlots is a bitmap with one bit per slot, set while the slot holds a tuple that is neither empty nor marked
+ *  deleted. Iteration finds the next live slot with a bit scan instead of reading the slot array.
+ *
+ *  Pages written before the bitmap existed have Format 0 and no LiveSlots, their slot array starts right after
+ *  Format. They are still read and written in that layout, live slots are then found by reading the slot array.
+ *  TupleCount never exceeds MAX_SLOTS, so the former 4 byte TupleCount of such a page reads as Format 0.
  **/
 
 #include <cstring>
@@ -47,6 +54,12 @@ class TablePage : public Page {
 
   bool InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Insert a tuple that is already serialized, e.g. one with fields stored in overflow pages.
+   * @param[out] rid the rid of the inserted tuple
+   */
+  bool InsertTuple(const char *data, uint32_t size, RowId *rid);
+
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
   bool UpdateTuple(const Row &new_row, Row *old_row, Schema *schema, Transaction *txn, LockManager *lock_manager,
@@ -62,6 +75,55 @@ class TablePage : public Page {
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint16_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /** @return true if the page keeps a live-slot bitmap, false for a page written in the former layout */
+  bool HasLiveSlots() { return *reinterpret_cast<uint16_t *>(GetData() + OFFSET_FORMAT) == FORMAT_LIVE_SLOTS; }
+
+  /** @return true if slot_num holds a tuple that is not marked deleted */
+  bool IsTupleLive(uint32_t slot_num) {
+    if (slot_num >= GetTupleCount()) {
+      return false;
+    }
+    if (!HasLiveSlots()) {
+      return !IsDeleted(GetTupleSize(slot_num));
+    }
+    return (reinterpret_cast<uint64_t *>(GetData() + OFFSET_LIVE_SLOTS)[slot_num / 64] >> (slot_num % 64)) & 1;
+  }
+
+  /** @return true if slot_num holds a tuple, even one marked deleted */
+  bool HoldsTuple(uint32_t slot_num) { return slot_num < GetTupleCount() && GetTupleSize(slot_num) != 0; }
+
+  /** @return the serialized tuple in slot_num, which must hold a tuple */
+  const char *GetTupleData(uint32_t slot_num) { return GetData() + GetTupleOffsetAtSlot(slot_num); }
+
+  /**
+   * Pack the tuple bodies against the end of the page and drop the empty slots at the end of the slot array. Live
+   * and delete-marked tuples keep their slot numbers, since row ids point at them.
+   * @return number of bytes of free space reclaimed
+   */
+  uint32_t Compact();
+
+  /** @return number of slots holding a live tuple */
+  uint32_t GetLiveTupleCount();
+
+  /** @return true if no slot of the page is in use any more */
+  bool IsEmpty() {
+    for (uint32_t i = 0; i < GetTupleCount(); i++) {
+      if (GetTupleSize(i) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - GetSlotArrayOffset() - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the free space a tuple of serialized_size bytes needs to be inserted */
+  static uint32_t GetSpaceNeeded(uint32_t serialized_size) { return serialized_size + SIZE_TUPLE; }
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -69,28 +131,50 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
   }
 
-  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
-
-  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
-
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  void SetTupleCount(uint32_t tuple_count) {
+    uint16_t count = tuple_count;
+    memcpy(GetData() + OFFSET_TUPLE_COUNT, &count, sizeof(uint16_t));
   }
 
+  /** @return offset of the slot array, which follows the header of the page's format */
+  uint32_t GetSlotArrayOffset() { return HasLiveSlots() ? SIZE_TABLE_PAGE_HEADER : SIZE_FORMER_HEADER; }
+
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
-    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
+    return *reinterpret_cast<uint32_t *>(GetData() + GetSlotArrayOffset() + SIZE_TUPLE * slot_num);
   }
 
   void SetTupleOffsetAtSlot(uint32_t slot_num, uint32_t offset) {
-    memcpy(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num, &offset, sizeof(uint32_t));
+    memcpy(GetData() + GetSlotArrayOffset() + SIZE_TUPLE * slot_num, &offset, sizeof(uint32_t));
   }
 
   uint32_t GetTupleSize(uint32_t slot_num) {
-    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
+    return *reinterpret_cast<uint32_t *>(GetData() + GetSlotArrayOffset() + OFFSET_SLOT_SIZE + SIZE_TUPLE * slot_num);
   }
 
   void SetTupleSize(uint32_t slot_num, uint32_t size) {
-    memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
+    memcpy(GetData() + GetSlotArrayOffset() + OFFSET_SLOT_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
+  }
+
+  /**
+   * Claim a slot and size bytes of free space for a new tuple, the caller writes the tuple at the slot's offset.
+   * @return false if the page has no room for it
+   */
+  bool ReserveTuple(uint32_t size, uint32_t *slot_num);
+
+  /** @return the first live slot at or after slot_num, GetTupleCount() if there is none */
+  uint32_t FindLiveSlot(uint32_t slot_num);
+
+  void SetLive(uint32_t slot_num, bool live) {
+    if (!HasLiveSlots()) {
+      return;
+    }
+    uint64_t *words = reinterpret_cast<uint64_t *>(GetData() + OFFSET_LIVE_SLOTS);
+    uint64_t mask = uint64_t{1} << (slot_num % 64);
+    if (live) {
+      words[slot_num / 64] |= mask;
+    } else {
+      words[slot_num / 64] &= ~mask;
+    }
   }
 
   static bool IsDeleted(uint32_t tuple_size) { return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0; }
@@ -102,16 +186,25 @@ class TablePage : public Page {
  private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
   static constexpr size_t SIZE_TUPLE = 8;
+  // every slot costs SIZE_TUPLE bytes, so a page never has more slots than the bitmap covers
+  static constexpr size_t MAX_SLOTS = PAGE_SIZE / SIZE_TUPLE;
+  static constexpr size_t SIZE_LIVE_SLOTS = MAX_SLOTS / 8;
+  static constexpr size_t SIZE_FORMER_HEADER = 24;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = SIZE_FORMER_HEADER + SIZE_LIVE_SLOTS;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FORMAT = 22;
+  static constexpr size_t OFFSET_LIVE_SLOTS = 24;
+  static constexpr size_t OFFSET_SLOT_SIZE = 4;
+  static constexpr uint16_t FORMAT_LIVE_SLOTS = 1;
+  static_assert(MAX_SLOTS <= UINT16_MAX);
+  static_assert(OFFSET_LIVE_SLOTS % sizeof(uint64_t) == 0 && SIZE_LIVE_SLOTS % sizeof(uint64_t) == 0);
 
  public:
+  // rows are sized for the current format, pages in the former layout have a little more room
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
@@ -18,6 +18,8 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class KeyManager;
+
  public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
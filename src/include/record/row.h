@@ -2,6 +2,7 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "common/macros.h"
@@ -19,7 +20,11 @@
  * | Field Nums | Null bitmap |
  * -------------------------------------------
  *
+ *  In memory a row keeps its fields by value in one buffer: a slot area of Field followed by a varlen tail
+ *  holding the data of its char fields, so building, copying or moving a row costs at most one allocation.
  *
+ *  A char field kept out of line in a chain of overflow pages is written as its length with OVERFLOW_FLAG set,
+ *  followed by the id of the first page of the chain instead of its data.
  */
 class Row {
  public:
@@ -27,23 +32,26 @@ class Row {
    * Row used for insert
    * Field integrity should check by upper level
    */
-  Row(std::vector<Field> &fields) {
-    // deep copy
+  Row(const std::vector<Field> &fields) {
+    // deep copy into one buffer
+    uint32_t varlen_size = 0;
     for (auto &field : fields) {
-      fields_.push_back(new Field(field));
+      varlen_size += GetVarlenSize(field);
+    }
+    Init(fields.size(), varlen_size);
+    for (uint32_t i = 0; i < fields.size(); i++) {
+      SetField(i, fields[i]);
     }
   }
 
   void destroy() {
-    if (!fields_.empty()) {
-      for (auto field : fields_) {
-        delete field;
-      }
-      fields_.clear();
-    }
+    buffer_.reset();
+    capacity_ = 0;
+    field_count_ = 0;
+    varlen_size_ = 0;
   }
 
-  ~Row() { destroy(); };
+  ~Row() = default;
 
   /**
    * Row used for deserialize
@@ -58,31 +66,68 @@ class Row {
   /**
    * Row copy function, deep copy
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
-    for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
-    }
+  Row(const Row &other) : rid_(other.rid_) { CopyFields(other); }
+
+  /**
+   * Row move function, takes over the buffer of other
+   */
+  Row(Row &&other) noexcept
+      : rid_(other.rid_),
+        buffer_(std::move(other.buffer_)),
+        capacity_(other.capacity_),
+        field_count_(other.field_count_),
+        varlen_size_(other.varlen_size_) {
+    other.destroy();
   }
 
   /**
    * Assign operator, deep copy
    */
   Row &operator=(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
-    for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+    if (this != &other) {
+      rid_ = other.rid_;
+      CopyFields(other);
     }
     return *this;
   }
 
+  /**
+   * Assign operator, takes over the buffer of other
+   */
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      rid_ = other.rid_;
+      buffer_ = std::move(other.buffer_);
+      capacity_ = other.capacity_;
+      field_count_ = other.field_count_;
+      varlen_size_ = other.varlen_size_;
+      other.destroy();
+    }
+    return *this;
+  }
+
+  /**
+   * Prepare the row for field_count fields whose char data take varlen_size bytes in total, all fields are null
+   * until set. The buffer is reused when it is large enough.
+   */
+  void Init(uint32_t field_count, uint32_t varlen_size);
+
+  /**
+   * Copy field into slot idx, char data is appended to the varlen tail reserved by Init
+   */
+  void SetField(uint32_t idx, const Field &field);
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
+  /**
+   * Serialize the row with some char fields stored out of line.
+   * @param overflow_pages first overflow page of every field, INVALID_PAGE_ID for a field stored inline
+   */
+  uint32_t SerializeTo(char *buf, Schema *schema, const std::vector<page_id_t> &overflow_pages) const;
+
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
   /**
@@ -92,24 +137,49 @@ class Row {
    */
   uint32_t GetSerializedSize(Schema *schema) const;
 
+  /**
+   * @return size of the row serialized with the fields that have an overflow page stored out of line
+   */
+  uint32_t GetSerializedSize(Schema *schema, const std::vector<page_id_t> &overflow_pages) const;
+
   void GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row);
 
+  /**
+   * Compare two rows of the same schema field by field, a null field orders before any value.
+   * @return <0, 0 or >0 as this row orders before, equal to or after other
+   */
+  int CompareTo(const Row &other) const;
+
   inline const RowId GetRowId() const { return rid_; }
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
 
-  inline std::vector<Field *> &GetFields() { return fields_; }
-
   inline Field *GetField(uint32_t idx) const {
-    ASSERT(idx < fields_.size(), "Failed to access field");
-    return fields_[idx];
+    ASSERT(idx < field_count_, "Failed to access field");
+    return reinterpret_cast<Field *>(buffer_.get()) + idx;
+  }
+
+  inline size_t GetFieldCount() const { return field_count_; }
+
+  /**
+   * @return bytes the data of field takes in the varlen tail of a row
+   */
+  static inline uint32_t GetVarlenSize(const Field &field) {
+    return field.GetTypeId() == TypeId::kTypeChar && !field.IsNull() ? field.GetLength() : 0;
   }
 
-  inline size_t GetFieldCount() const { return fields_.size(); }
+  static constexpr uint32_t OVERFLOW_FLAG = 1U << 31;
+  static constexpr uint32_t SIZE_OVERFLOW_FIELD = sizeof(uint32_t) + sizeof(page_id_t);
 
  private:
+  void CopyFields(const Row &other);
+
   RowId rid_{};
-  std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  /** Fixed-width Field slots followed by the varlen tail their char data point into */
+  std::unique_ptr<char[]> buffer_{nullptr};
+  uint32_t capacity_{0};
+  uint32_t field_count_{0};
+  uint32_t varlen_size_{0}; /** bytes of the varlen tail in use */
 };
 
 #endif  // MINISQL_ROW_H
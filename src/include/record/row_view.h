@@ -0,0 +1,126 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * RowProjection lists the columns of a schema a scan reads, e.g. those of the output and the predicate of a query.
+ *
+ * A RowView given a projection decodes a row in one pass that stops at the last column read and remembers only the
+ * offsets of the columns read. The columns in between are skipped by a size precomputed per column, so the pass does
+ * not look up their types in the schema.
+ */
+class RowProjection {
+ public:
+  /**
+   * @param columns the columns read, in any order, duplicates allowed
+   */
+  RowProjection(const Schema *schema, const std::vector<uint32_t> &columns);
+
+  /** @return true if column idx is read */
+  inline bool Contains(uint32_t idx) const { return idx < slots_.size() && slots_[idx] >= 0; }
+
+ private:
+  friend class RowView;
+
+  std::vector<uint32_t> sizes_;  // size of every column up to the last one read, 0 for char columns
+  std::vector<int32_t> slots_;   // position of every column among the columns read, -1 if it is not read
+  uint32_t column_count_{0};     // number of columns read
+};
+
+/**
+ * RowView reads a serialized row in place, e.g. inside a pinned table page, without building a Row.
+ *
+ * Fields are decoded on access. The offsets of the fields decoded so far are remembered, so reading the fields of a
+ * row in any order walks the row only once. A char field returned by GetField points into the viewed buffer and is
+ * only valid as long as the buffer is; ToRow copies the fields out.
+ *
+ * A char field stored in overflow pages is only read when it is accessed, through the OverflowReader given to Reset.
+ * The data read is kept by the view until it is reset, so fields that are never accessed never touch their overflow
+ * pages.
+ */
+class RowView {
+ public:
+  /** Reads size bytes of the overflow chain starting at first_page_id into buf */
+  using OverflowReader = std::function<void(page_id_t first_page_id, uint32_t size, char *buf)>;
+
+  RowView() = default;
+
+  /**
+   * Point the view at another serialized row.
+   * @param overflow_reader reads the fields stored in overflow pages, may be nullptr if the row has none
+   * @param projection the columns that will be read, nullptr if any column may be
+   */
+  void Reset(const char *data, const Schema *schema, RowId rid, const OverflowReader *overflow_reader = nullptr,
+             const RowProjection *projection = nullptr) {
+    data_ = data;
+    schema_ = schema;
+    rid_ = rid;
+    overflow_reader_ = overflow_reader;
+    projection_ = projection;
+    offsets_.clear();
+    overflow_data_.clear();
+  }
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return MACH_READ_UINT32(data_); }
+
+  inline bool IsNull(uint32_t idx) const {
+    return (static_cast<uint8_t>(data_[sizeof(uint32_t) + idx / 8]) >> (idx % 8)) & 1;
+  }
+
+  /** @return true if field idx is a char field stored in overflow pages */
+  bool IsOverflow(uint32_t idx) const;
+
+  /** @return first page of the overflow chain of field idx, which must be stored in overflow pages */
+  inline page_id_t GetOverflowPageId(uint32_t idx) const {
+    return MACH_READ_FROM(page_id_t, data_ + GetFieldOffset(idx) + sizeof(uint32_t));
+  }
+
+  /** @return size of the serialized row, fields stored in overflow pages count only their reference */
+  inline uint32_t GetSerializedSize() const { return GetFieldOffset(GetFieldCount()); }
+
+  /**
+   * @return field idx of the row, a char field does not own its data
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Copy all fields into row, the rid of the view is wrapped in row as well.
+   */
+  void ToRow(Row *row) const;
+
+  /**
+   * Copy the given fields into row, in the given order.
+   */
+  void ToRow(const std::vector<uint32_t> &columns, Row *row) const;
+
+ private:
+  /** @return offset of field idx from the start of the row */
+  uint32_t GetFieldOffset(uint32_t idx) const;
+
+  /** Decode the offsets of all columns read by projection_ in one pass */
+  void DecodeProjection() const;
+
+  /** @return the data of the overflow field whose length word is at buf, read on first access */
+  char *ReadOverflow(const char *buf) const;
+
+ private:
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowId rid_{};
+  const OverflowReader *overflow_reader_{nullptr};
+  const RowProjection *projection_{nullptr};                    // columns read, nullptr if any column may be
+  mutable std::vector<uint32_t> offsets_;                        // offsets of the fields decoded so far
+  mutable std::vector<std::unique_ptr<char[]>> overflow_data_;  // overflow fields read so far
+};
+
+#endif  // MINISQL_ROW_VIEW_H
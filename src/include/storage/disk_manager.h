@@ -2,10 +2,17 @@
 #define DISK_MGR_H
 
 #include <atomic>
-#include <fstream>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
@@ -19,10 +26,42 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages are read and written with positional pread/pwrite on a plain file descriptor, so concurrent reads and writes
+ * of data pages do not share a stream cursor and need no latch. Page allocation still runs under db_io_latch_.
+ *
+ * Allocation never touches the disk: bitmap pages are cached in memory once read and, like the meta page, written
+ * back by FlushMetadata and on Close. The buffer pool flushes them before it writes back a batch of data pages, so
+ * a page written that way is never found free in the file after a crash. The extents with free pages are kept in an
+ * ordered set, so allocation goes straight to the first of them and the bitmap finds a free bit a word at a time.
+ *
+ * Asynchronous I/O is served by a pool of DISK_IO_THREADS worker threads, started on first use. Requests are routed
+ * to a worker by page id, so the requests of one page complete in submission order. Data of an asynchronous write is
+ * copied at submission: until the write reaches the file, ReadPage serves the page from that copy and WritePage waits
+ * for it, so callers always see their latest write.
+ *
+ * A database that never changes can be opened read-only. The file is then mapped into memory once and the buffer
+ * pool points its frames straight into the mapping with GetPageView instead of reading pages into frame memory.
+ * The mapping is private, so stray in-memory modifications never reach the file; every write, allocation and
+ * deallocation is rejected.
+ *
+ * With checksums enabled, a CRC32 of every page written is kept in a side file next to the database file (four
+ * bytes per physical page) and every page read is verified against it, so a page torn by a crash or corrupted on
+ * disk is detected. A read of such a page fails, and the buffer pool does not bring it in. Pages written without checksums have no entry and are not verified, so checksums must stay
+ * enabled once a file was written with them.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param db_file path of the database file, created if it does not exist
+   * @param direct_io open the file with O_DIRECT to bypass the OS page cache. Buffers that are not aligned to
+   *                  PAGE_SIZE go through an aligned bounce buffer. Falls back to buffered I/O if the file system
+   *                  does not support it.
+   * @param read_only map an existing database file read-only, direct_io is ignored in this mode
+   * @param checksums keep a CRC32 per page in db_file + ".crc" and verify pages on read
+   */
+  explicit DiskManager(const std::string &db_file, bool direct_io = false, bool read_only = false,
+                       bool checksums = false);
 
   ~DiskManager() {
     if (!closed) {
@@ -33,8 +72,9 @@ class DiskManager {
   /**
    * Read page from specific page_id
    * Note: page_id = 0 is reserved for free page bit map
+   * @return false if the page failed its checksum, page_data then holds the corrupt data
    */
-  void ReadPage(page_id_t logical_page_id, char *page_data);
+  bool ReadPage(page_id_t logical_page_id, char *page_data);
 
   /**
    * Write data to specific page
@@ -42,6 +82,38 @@ class DiskManager {
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Write a batch of pages, e.g. for a checkpoint. Runs of physically consecutive pages go out with one vectored
+   * write, so callers should pass the pages in page id order.
+   * @param pages <logical page id, page data> pairs
+   */
+  void WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * Read a page in the background.
+   * @param page_data buffer to fill, must stay valid until the returned future is ready
+   * @return a future that holds a std::runtime_error if the page failed its checksum
+   */
+  std::future<void> ReadPageAsync(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Write a page in the background. page_data is copied, so the caller may reuse it as soon as this returns.
+   */
+  std::future<void> WritePageAsync(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Submit a batch of reads at once, spread over all I/O workers.
+   * @return a future that is ready when every page of the batch has been read, it holds a std::runtime_error if
+   *         any of them failed its checksum
+   */
+  std::future<void> ReadPagesAsync(const std::vector<std::pair<page_id_t, char *>> &pages);
+
+  /**
+   * Submit a batch of writes at once, spread over all I/O workers. The data is copied as in WritePageAsync.
+   * @return a future that is ready when every page of the batch has been written
+   */
+  std::future<void> WritePagesAsync(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
@@ -58,6 +130,12 @@ class DiskManager {
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * Write back the bitmap pages and the meta page changed since they were last written, so that the allocation
+   * state in the file covers every page allocated so far. Does nothing in read-only mode.
+   */
+  void FlushMetadata();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -69,37 +147,161 @@ class DiskManager {
    */
   char *GetMetaData() { return meta_data_; }
 
-  static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  /** @return true if the file is accessed with O_DIRECT */
+  bool IsDirectIO() const { return direct_io_; }
+
+  /** @return true if pages are checksummed */
+  bool IsChecksummed() const { return crc_fd_ >= 0; }
+
+  /** @return number of pages read so far whose data did not match their checksum */
+  size_t GetChecksumFailures() const { return checksum_failures_; }
+
+  /**
+   * @return CRC32 of a page, never 0 since 0 marks a page without checksum in the side file
+   */
+  static uint32_t PageChecksum(const char *page_data);
+
+  /** @return true if the file is mapped read-only */
+  bool IsReadOnly() const { return read_only_; }
 
- private:
   /**
-   * Helper function to get disk file size
+   * Only available in read-only mode.
+   * @return the data of the page inside the file mapping, a zeroed page if it lies past the end of the file,
+   *         nullptr if the page failed its checksum
    */
-  int GetFileSize(const std::string &file_name);
+  char *GetPageView(page_id_t logical_page_id);
+
+  static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+ private:
   /**
    * Read physical page from disk
+   * @return false if the page failed its checksum
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  bool ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
 
   /**
    * Write data to physical page in disk
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  /**
+   * Write count physically consecutive pages with one vectored write
+   */
+  void WritePhysicalPages(page_id_t physical_page_id, const char *const *pages_data, size_t count);
+
+  /**
+   * Record the checksums of count physically consecutive pages
+   */
+  void WriteChecksums(page_id_t physical_page_id, const char *const *pages_data, size_t count);
+
+  /**
+   * Compare a page read from disk with its recorded checksum, a mismatch is logged and counted
+   * @return false on a mismatch, true if the page matches or has no checksum
+   */
+  bool VerifyChecksum(page_id_t physical_page_id, const char *page_data);
+
+  /**
+   * @return a PAGE_SIZE aligned buffer owned by the calling thread, used for O_DIRECT transfers
+   */
+  static char *BounceBuffer();
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * @return the cached bitmap of an extent, read from disk on first use. Must be called with db_io_latch_ held.
+   */
+  BitmapPage<PAGE_SIZE> *GetExtentBitmap(uint32_t extent_id);
+
+  /**
+   * Write back the cached bitmaps modified since they were read. Must be called with db_io_latch_ held.
+   */
+  void FlushBitmaps();
+
+  /** Completion state shared by the requests of one asynchronous submission. */
+  struct AsyncBatch {
+    explicit AsyncBatch(size_t count) : remaining(count) {}
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed{false};
+    std::promise<void> done;
+  };
+
+  /** One asynchronous request, a read if read_buf is set and a write of write_data otherwise. */
+  struct AsyncRequest {
+    page_id_t page_id;
+    char *read_buf;
+    std::shared_ptr<char[]> write_data;
+    std::shared_ptr<AsyncBatch> batch;
+  };
+
+  /** An I/O worker thread with its own FIFO queue. */
+  struct AsyncWorker {
+    std::mutex latch;
+    std::condition_variable cv;
+    std::deque<AsyncRequest> queue;
+    std::thread thread;
+  };
+
+  /** Latest data of a page with asynchronous writes still in flight. */
+  struct PendingWrite {
+    std::shared_ptr<char[]> data;
+    size_t count;
+  };
+
+  /**
+   * Queue the requests on their workers, starting the workers on first use.
+   * @return future of the whole submission
+   */
+  std::future<void> SubmitAsync(std::vector<AsyncRequest> &&requests);
+
+  /**
+   * Body of an I/O worker thread, serves its queue until it is empty and the disk manager is closing.
+   */
+  void AsyncWorkerLoop(AsyncWorker *worker);
+
+  /**
+   * Stop and join the I/O workers after they drained their queues.
+   */
+  void StopAsyncWorkers();
+
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  bool direct_io_{false};
+  bool read_only_{false};
+  // file descriptor of the checksum side file, -1 without checksums
+  int crc_fd_{-1};
+  std::atomic<size_t> checksum_failures_{0};
+  // private mapping of the whole file in read-only mode
+  char *mapping_{nullptr};
+  size_t mapping_size_{0};
+  // served for pages past the end of the mapping
+  char zero_page_[PAGE_SIZE]{};
+  // cached size of db file, so reads past the end need no stat()
+  std::atomic<size_t> file_size_{0};
+  // protects the meta page and the bitmap pages, page allocation is shared by all buffer pool instances
   std::recursive_mutex db_io_latch_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
+  bool meta_dirty_{false};
+  // cached bitmap pages indexed by extent, nullptr until first used
+  std::vector<std::unique_ptr<char[]>> bitmaps_;
+  std::vector<bool> dirty_bitmaps_;
+  // extents that still have free pages, allocation takes the first one
+  std::set<uint32_t> free_extents_;
+
+  // asynchronous I/O workers, started on first use
+  std::vector<std::unique_ptr<AsyncWorker>> async_workers_;
+  std::once_flag async_start_flag_;
+  std::atomic<bool> stop_async_{false};
+  // pages with asynchronous writes in flight, num_pending_writes_ lets synchronous I/O skip async_latch_
+  std::mutex async_latch_;
+  std::unordered_map<page_id_t, PendingWrite> pending_writes_;
+  std::atomic<size_t> num_pending_writes_{0};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * FreeSpaceMap tracks the free space of every page of a table heap, so that an insert goes straight to a page with
+ * enough room instead of walking the page chain.
+ *
+ * Since its entries follow the page chain, the map is also the page directory of the heap: it answers the page
+ * count, the i-th page and the position of a page without touching any table page.
+ *
+ * The map is persisted in a chain of FreeSpaceMapPage and read into memory on first use. In memory, the entries of
+ * every free space bucket are kept ordered by their position in the heap, so a lookup costs at most NUM_BUCKETS set
+ * probes and no page fetch. A map created with INVALID_PAGE_ID as first page lives in memory only.
+ *
+ * Only the bucket of a page is persisted, but the map keeps the exact free space of every page updated since it was
+ * loaded. A lookup can take a hint page whose exact free space is checked, so that the page the heap is filling is
+ * used up to its last row instead of being left once its free space rounds down below the row's bucket.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * @param first_page_id first page of a persisted map, INVALID_PAGE_ID for a map that is kept in memory only
+   */
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id = INVALID_PAGE_ID)
+      : buffer_pool_manager_(buffer_pool_manager), first_page_id_(first_page_id) {}
+
+  /**
+   * Allocate the first page of a new, empty persisted map.
+   * @return false if the page could not be allocated
+   */
+  bool Create();
+
+  /**
+   * Read the map into memory. A map that is not persisted starts out empty.
+   */
+  void Load();
+
+  /**
+   * Release the pages of the map.
+   */
+  void Destroy();
+
+  /**
+   * Forget all entries, e.g. before the map is rebuilt. A persisted map keeps its first page and releases the rest.
+   */
+  void Clear();
+
+  /**
+   * @param hint a page to prefer, e.g. the page of the last insert, if its exact free space fits size but is rounded
+   *             down below the buckets searched
+   * @return a page with at least size free bytes, preferring pages early in the heap, INVALID_PAGE_ID if none
+   */
+  page_id_t FindPage(uint32_t size, page_id_t hint = INVALID_PAGE_ID) const;
+
+  /**
+   * Record the free space of a table page, appending the page to the map if it is not in it yet.
+   */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /** @return number of recorded pages */
+  size_t GetPageCount() const { return entries_.size(); }
+
+  /** @return the index-th recorded page, i.e. the index-th page of the heap */
+  page_id_t GetPageIdAt(size_t index) const { return entries_[index].first; }
+
+  /** @return the free space of the index-th recorded page, rounded down to its bucket if not updated since loaded */
+  uint32_t GetFreeSpaceAt(size_t index) const { return entries_[index].second; }
+
+  /** @return position of page_id in the heap, GetPageCount() if the page is not recorded */
+  size_t IndexOf(page_id_t page_id) const {
+    auto iter = entry_index_.find(page_id);
+    return iter == entry_index_.end() ? entries_.size() : iter->second;
+  }
+
+  /** @return all recorded pages in the order they were recorded, i.e. in heap order */
+  std::vector<page_id_t> GetPageIds() const {
+    std::vector<page_id_t> page_ids;
+    page_ids.reserve(entries_.size());
+    for (auto &entry : entries_) {
+      page_ids.push_back(entry.first);
+    }
+    return page_ids;
+  }
+
+  /** @return the page recorded last, i.e. the tail of the heap, INVALID_PAGE_ID if the map is empty */
+  page_id_t GetLastPageId() const { return entries_.empty() ? INVALID_PAGE_ID : entries_.back().first; }
+
+  inline page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  inline bool IsLoaded() const { return loaded_; }
+
+  inline bool IsPersistent() const { return first_page_id_ != INVALID_PAGE_ID; }
+
+ private:
+  /**
+   * Write the bucket of entry index to its map page, appending it if append is set.
+   */
+  void Persist(uint32_t index, bool append);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_;
+  bool loaded_{false};
+  std::vector<page_id_t> map_pages_;                      // the chain of map pages
+  std::vector<std::pair<page_id_t, uint32_t>> entries_;  // <table page, free space>, entry i is in map page i / MAX
+  std::unordered_map<page_id_t, uint32_t> entry_index_;  // table page -> entry
+  std::set<uint32_t> buckets_[FreeSpaceMapPage::NUM_BUCKETS];  // entries in each bucket
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_H
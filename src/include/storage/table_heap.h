@@ -3,13 +3,17 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "page/header_page.h"
+#include "page/overflow_page.h"
 #include "page/table_page.h"
+#include "storage/free_space_map.h"
 #include "storage/table_iterator.h"
+#include "storage/table_scan_cursor.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 
 class TableHeap {
   friend class TableIterator;
+  friend class TableScanCursor;
 
  public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
@@ -17,21 +21,40 @@ class TableHeap {
     return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
   }
 
+  /**
+   * Open an existing table heap.
+   * @param free_space_map_page_id first page of its free space map, INVALID_PAGE_ID to rebuild the map in memory
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           page_id_t free_space_map_page_id = INVALID_PAGE_ID) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager,
+                         free_space_map_page_id);
   }
 
   ~TableHeap() {}
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The target page comes from the free space map, the tuple goes to the tail page or a new page if no page has
+   * room for it. Char fields longer than OVERFLOW_FIELD_SIZE are stored in a chain of overflow pages, the tuple only
+   * refers to them, so they count against the size of the tuple with a few bytes only.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Insert a batch of tuples into the table. Each target page is pinned once and filled with as many of the rows as
+   * fit, and the free space map is updated once per page instead of once per row.
+   * @param[in/out] rows Tuple Rows to insert in order, the rid of every inserted tuple is wrapped in its row
+   * @param[in] txn The transaction performing the insert
+   * @return false if any of the rows is too large or could not be stored, the rows inserted before are deleted
+   *         again then
+   */
+  bool InsertTuples(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -41,7 +64,8 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * Update a tuple in place, it keeps its rid. If the new tuple is too large to fit in the old page, return false
+   * (will delete and insert). Tuples with fields in overflow pages, old or new, are never updated in place.
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -50,7 +74,8 @@ class TableHeap {
   bool UpdateTuple(const Row &row, const RowId &rid, Transaction *txn);
 
   /**
-   * Called on Commit/Abort to actually delete a tuple or rollback an insert.
+   * Called on Commit/Abort to actually delete a tuple or rollback an insert. The overflow pages of the tuple are
+   * freed with it.
    * @param rid Rid of the tuple to delete
    * @param txn Transaction performing the delete.
    */
@@ -71,22 +96,28 @@ class TableHeap {
    */
   bool GetTuple(Row *row, Transaction *txn);
 
-  void FreeTableHeap() {
-    auto next_page_id = first_page_id_;
-    while (next_page_id != INVALID_PAGE_ID) {
-      auto old_page_id = next_page_id;
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
-      assert(page != nullptr);
-      next_page_id = page->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(old_page_id, false);
-      buffer_pool_manager_->DeletePage(old_page_id);
-    }
-  }
+  void FreeTableHeap() { DeleteTable(); }
 
   /**
-   * Free table heap and release storage in disk file
+   * Compact every page of the heap, unlink and free the pages that hold no tuple any more and rebuild the free space
+   * map. The first page is always kept, the catalog refers to it.
+   * @return number of bytes reclaimed, a freed page counts as PAGE_SIZE
    */
-  void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
+  size_t Vacuum(Transaction *txn);
+
+  /**
+   * Vacuum the heap if at least AUTOVACUUM_EMPTY_PAGES pages were emptied by deletes since the last vacuum. Must
+   * not be called while an iterator of the heap is in use.
+   * @return number of bytes reclaimed, 0 if the heap was not vacuumed
+   */
+  size_t AutoVacuum(Transaction *txn);
+
+  /**
+   * Free table heap and release storage in disk file. The pages are taken from the page directory, so dropping a
+   * table neither recurses nor walks the page chain. If the schema has char columns, every page is read once to
+   * free the overflow pages of its tuples.
+   */
+  void DeleteTable();
 
   /**
    * @return the begin iterator of this table
@@ -103,7 +134,105 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the ids of all pages of the heap in page chain order, read from the free space map without walking the
+   * chain
+   */
+  std::vector<page_id_t> GetPageIds() {
+    LoadFreeSpaceMap();
+    return free_space_map_.GetPageIds();
+  }
+
+  /** @return number of pages of the heap, from the page directory */
+  size_t GetPageCount() {
+    LoadFreeSpaceMap();
+    return free_space_map_.GetPageCount();
+  }
+
+  /** @return the index-th page of the heap in page chain order, from the page directory */
+  page_id_t GetPageIdAt(size_t index) {
+    LoadFreeSpaceMap();
+    return free_space_map_.GetPageIdAt(index);
+  }
+
+  /**
+   * @return the id of the first page of the free space map, INVALID_PAGE_ID if it is only kept in memory
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return free_space_map_.GetFirstPageId(); }
+
+  /**
+   * Set how many pages of the page chain a sequential scan reads ahead, 0 disables read-ahead.
+   */
+  inline void SetPrefetchWindow(size_t prefetch_window) { prefetch_window_ = prefetch_window; }
+
+  inline size_t GetPrefetchWindow() const { return prefetch_window_; }
+
 private:
+  /**
+   * Ask the buffer pool to read ahead prefetch_window_ pages of the chain, starting at page_id. The page ids are
+   * taken from the page directory, so the reads do not depend on each other.
+   */
+  void PrefetchFrom(page_id_t page_id);
+
+  /**
+   * Read the free space map on first use, a map that is not persisted is rebuilt by walking the page chain once
+   */
+  void LoadFreeSpaceMap();
+
+  /**
+   * Record the current free space of page in the free space map
+   */
+  void UpdateFreeSpace(TablePage *page);
+
+  /**
+   * @return placeholder overflow pages of the fields of row to store out of line, see Row::SerializeTo, empty if
+   * every field is stored inline
+   */
+  std::vector<page_id_t> GetOverflowFields(const Row &row) const;
+
+  /**
+   * Write the fields of row marked in overflow_pages to new overflow chains and serialize row referring to them.
+   * @param[in/out] overflow_pages placeholders from GetOverflowFields, replaced by the first page of every chain
+   * @param[out] stored the serialized row
+   * @return false if an overflow page can not be allocated, no overflow page is kept then
+   */
+  bool StoreOverflowFields(const Row &row, std::vector<page_id_t> *overflow_pages, std::vector<char> *stored);
+
+  /**
+   * Insert row into page, as the serialized stored if that is not empty
+   */
+  bool InsertIntoPage(TablePage *page, Row &row, const std::vector<char> &stored, Transaction *txn);
+
+  /**
+   * Copy the tuple rid, which must be live in page, into row and read its overflow fields
+   */
+  void ReadTuple(TablePage *page, const RowId &rid, Row *row);
+
+  /**
+   * @return first pages of the overflow chains the tuple in slot_num of page refers to
+   */
+  std::vector<page_id_t> GetTupleOverflowPages(TablePage *page, uint32_t slot_num);
+
+  /**
+   * @return true if tuples of the schema may have fields in overflow pages, i.e. it has a char column
+   */
+  bool MayOverflow() const;
+
+  /**
+   * @return first page of a new overflow chain holding size bytes of data, INVALID_PAGE_ID if out of pages
+   */
+  page_id_t WriteOverflow(const char *data, uint32_t size);
+
+  /**
+   * Read size bytes from the overflow chain starting at first_page_id
+   */
+  void ReadOverflow(page_id_t first_page_id, uint32_t size, char *buf);
+
+  /**
+   * Free the overflow chain starting at first_page_id
+   */
+  void FreeOverflow(page_id_t first_page_id);
+
   /**
    * create table heap and initialize first page
    */
@@ -112,29 +241,42 @@ private:
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
+          lock_manager_(lock_manager),
+          free_space_map_(buffer_pool_manager) {
     TablePage *firstPg = reinterpret_cast<TablePage *>
               (buffer_pool_manager_->NewPage(first_page_id_));
     ASSERT(firstPg != nullptr, "Error: TableHeap cannot create first page.");
     /* 根据双向链表性质，首元素前一元素是尾元素 */
     firstPg->Init(first_page_id_, PAGE_SIZE, log_manager_, txn);
+    /* 新建空闲空间映射，记录首页 */
+    bool __attribute__((unused)) map_created = free_space_map_.Create();
+    ASSERT(map_created, "Error: TableHeap cannot create free space map.");
+    free_space_map_.Update(first_page_id_, firstPg->GetFreeSpaceRemaining());
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, page_id_t free_space_map_page_id)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        free_space_map_(buffer_pool_manager, free_space_map_page_id) {}
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  size_t prefetch_window_{TABLE_PREFETCH_WINDOW};
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  FreeSpaceMap free_space_map_;
+  size_t emptied_pages_{0};  // pages left without live tuple by a delete since the last vacuum
+  page_id_t last_insert_page_id_{INVALID_PAGE_ID};  // page of the last insert, tried first by the next one
+  // handed to the row views of scans, which read overflow fields only when they are accessed
+  RowView::OverflowReader overflow_reader_{
+      [this](page_id_t first_page_id, uint32_t size, char *buf) { ReadOverflow(first_page_id, size, buf); }};
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
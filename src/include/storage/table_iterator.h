@@ -35,6 +35,7 @@ public:
 private:
   Row row;
   TableHeap *source;
+  size_t pages_until_prefetch{0};  // page switches left before the next read-ahead request
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
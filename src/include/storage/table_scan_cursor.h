@@ -0,0 +1,68 @@
+#ifndef MINISQL_TABLE_SCAN_CURSOR_H
+#define MINISQL_TABLE_SCAN_CURSOR_H
+
+#include <vector>
+
+#include "page/table_page.h"
+#include "record/row_view.h"
+
+class TableHeap;
+
+/**
+ * TableScanCursor walks all tuples of a table heap in page chain order and exposes each one as a RowView into its
+ * page, so a scan copies nothing but the rows it keeps.
+ *
+ * The current page stays pinned until the cursor moves past its last tuple, so moving within a page costs no
+ * buffer pool call at all. The view returned by Get is only valid until the next call to Next. The heap may be
+ * modified through TableHeap during the scan, but must not be vacuumed or deleted while a cursor is open.
+ */
+class TableScanCursor {
+ public:
+  explicit TableScanCursor(TableHeap *table_heap);
+
+  /**
+   * Scan only the given pages of the heap, in the given order and without read-ahead, e.g. one morsel of a
+   * parallel scan.
+   */
+  TableScanCursor(TableHeap *table_heap, std::vector<page_id_t> page_ids);
+
+  ~TableScanCursor() { Close(); }
+
+  TableScanCursor(const TableScanCursor &other) = delete;
+
+  TableScanCursor &operator=(const TableScanCursor &other) = delete;
+
+  /**
+   * Move to the next tuple, to the first one on the first call.
+   * @return false if there are no more tuples, the cursor holds no pin then
+   */
+  bool Next();
+
+  /**
+   * Declare the only columns that will be read from the views, the rows are then decoded up to the last of them.
+   * @param projection must outlive the cursor, nullptr if any column may be read
+   */
+  inline void SetProjection(const RowProjection *projection) { projection_ = projection; }
+
+  /** @return the current tuple */
+  inline const RowView &Get() const { return view_; }
+
+  /**
+   * Unpin the current page and end the scan.
+   */
+  void Close();
+
+ private:
+  TableHeap *table_heap_;
+  TablePage *page_{nullptr};                  // pinned current page, nullptr between pages
+  page_id_t next_page_id_;                    // page to visit once page_ is done
+  bool follow_chain_{true};                   // take the next page from the page chain, not from page_ids_
+  std::vector<page_id_t> page_ids_;           // pages to visit when not following the chain
+  size_t next_page_index_{0};                 // next page of page_ids_ to visit
+  bool fresh_page_{false};                    // no tuple of page_ has been visited yet
+  size_t pages_until_prefetch_{0};            // page switches left before the next read-ahead request
+  const RowProjection *projection_{nullptr};  // columns read from the views, nullptr if any column may be
+  RowView view_;
+};
+
+#endif  // MINISQL_TABLE_SCAN_CURSOR_H
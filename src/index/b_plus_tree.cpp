@@ -17,7 +17,7 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
       buffer_pool_manager_(buffer_pool_manager),
       processor_(KM)
 {
-    auto root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID));
+    auto root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
     if (!root_page->GetRootId(index_id, &this->root_page_id_))
     {
       this->root_page_id_ = INVALID_PAGE_ID;
@@ -55,12 +55,14 @@ bool BPlusTree::IsEmpty() const {
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the only value that associated with input key, or every value of
+ * the key if the index is not unique
  * This method is used for point query
  * @return : true means key exists
  */
 bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction) {
   if(IsEmpty()) return false;
+  if(!processor_.IsUnique()) return GetValues(key, result);
 
   Page* leaf_page = this->FindLeafPage(key);
   LeafPage *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
@@ -82,6 +84,39 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Tran
   }
 }
 
+/*
+ * Collect the values of every entry whose columns equal key
+ * 不带RowId的key排在同键的所有项之前，从它的位置起沿叶节点链表向后收集
+ */
+bool BPlusTree::GetValues(const GenericKey *key, std::vector<RowId> &result) {
+  /* FindLeafPage返回前已unpin叶节点，重新pin住，之后每页恰好unpin一次 */
+  Page *leaf_page = buffer_pool_manager_->FetchPage(FindLeafPage(key)->GetPageId());
+  auto *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  size_t org_size = result.size();
+  int index = leaf_node->KeyIndex(key, processor_);
+
+  while (true) {
+    /* 1. 收集本页中同键的项 */
+    for (; index < leaf_node->GetSize(); index++) {
+      if (processor_.CompareColumns(key, leaf_node->KeyAt(index)) != 0) {
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+        return result.size() > org_size;
+      }
+      result.push_back(leaf_node->ValueAt(index));
+    }
+
+    /* 2. 同键的项可能延续到下一页 */
+    page_id_t next_page_id = leaf_node->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return result.size() > org_size;
+    }
+    leaf_page = buffer_pool_manager_->FetchPage(next_page_id);
+    leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    index = 0;
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -351,7 +386,7 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
 bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
                          Transaction *transaction) {
     if (index == 0) { swap(node, neighbor_node); }
-    auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, node->GetPageId(), true));
+    auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, node->GetPageId(), true)->GetData());
     GenericKey *key = temp_page->KeyAt(0);
     buffer_pool_manager_->UnpinPage(temp_page->GetPageId(), false);
     node->MoveAllTo(neighbor_node, key, buffer_pool_manager_);
@@ -379,12 +414,12 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
 
 void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
     if (index == 0) {
-        auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, neighbor_node->GetPageId(), true));
+        auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, neighbor_node->GetPageId(), true)->GetData());
         GenericKey *key = temp_page->KeyAt(0);
         buffer_pool_manager_->UnpinPage(temp_page->GetPageId(), false);
         neighbor_node->MoveFirstToEndOf(node, key, buffer_pool_manager_);
     } else {
-        auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, node->GetPageId(), true));
+        auto *temp_page = reinterpret_cast<LeafPage *>(FindLeafPage(nullptr, node->GetPageId(), true)->GetData());
         GenericKey *key = temp_page->KeyAt(0);
         buffer_pool_manager_->UnpinPage(temp_page->GetPageId(), false);
         neighbor_node->MoveLastToFrontOf(node, key, buffer_pool_manager_);
@@ -402,13 +437,13 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
  */
 bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
     if (old_root_node->GetSize() == 0) {
-        auto index_root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
+        auto index_root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
         index_root_page->Delete(index_id_);
         buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
         return true;
     } else if (old_root_node->GetSize() == 1) {
         root_page_id_ = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
-        auto new_root_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(root_page_id_));
+        auto new_root_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
         new_root_page->SetParentPageId(INVALID_PAGE_ID);
         buffer_pool_manager_->UnpinPage(root_page_id_, true);
         UpdateRootPageId(0);         // 默认为false
@@ -440,13 +475,21 @@ IndexIterator BPlusTree::Begin() {
  */
 IndexIterator BPlusTree::Begin(const GenericKey *key) {
     if (IsEmpty()) return IndexIterator();
-    auto leaf_page = reinterpret_cast<LeafPage *>(FindLeafPage(key, root_page_id_, false));
-    buffer_pool_manager_ ->UnpinPage(leaf_page->GetPageId(), false);
+    /* FindLeafPage返回前已unpin叶节点，重新pin住，读完所需的值后再unpin */
+    page_id_t leaf_page_id = FindLeafPage(key, root_page_id_, false)->GetPageId();
+    auto leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(leaf_page_id)->GetData());
     int index = leaf_page->KeyIndex(key, processor_);
+    int size = leaf_page->GetSize();
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+    /* key大于本页所有键时从下一页的第一项开始 */
+    if(index == size && next_page_id != INVALID_PAGE_ID){
+        return IndexIterator(next_page_id, buffer_pool_manager_);
+    }
     if(index == -1){
         return IndexIterator();
     } else{
-        return IndexIterator(leaf_page->GetPageId(), buffer_pool_manager_, index);
+        return IndexIterator(leaf_page_id, buffer_pool_manager_, index);
     }
 }
 
@@ -484,7 +527,8 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
     if(IsEmpty()) return nullptr;
     page_id_t next_page_id = page_id;
     if(page_id == INVALID_PAGE_ID) next_page_id = root_page_id_;
-    auto page = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    Page *raw_page = buffer_pool_manager_->FetchPage(next_page_id);
+    auto page = reinterpret_cast<InternalPage *>(raw_page->GetData());
     // 根节点被pin
 
     while (!page->IsLeafPage()){
@@ -492,13 +536,14 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
       // Unpin当前层
       next_page_id = leftMost ? page->ValueAt(0)
                               : page->Lookup(key, processor_);
-      page = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      raw_page = buffer_pool_manager_->FetchPage(next_page_id);
+      page = reinterpret_cast<InternalPage *>(raw_page->GetData());
       // pin下一层
     }
 
     buffer_pool_manager_->UnpinPage(next_page_id, false);
 
-    return reinterpret_cast<Page *>(page);
+    return raw_page;
 }
 
 /*
@@ -511,7 +556,7 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
     auto root_index_page =
-            reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_ -> FetchPage(INDEX_ROOTS_PAGE_ID));
+            reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_ -> FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
 
     /* 如果 insert_record 为false， Update，否则 Insert */
     if(!insert_record) {
@@ -4,15 +4,15 @@
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
+                               BufferPoolManager *buffer_pool_manager, bool unique)
     : Index(index_id, key_schema),
-      processor_(key_schema_, key_size),
+      processor_(key_schema_, key_size, unique),
       container_(index_id, buffer_pool_manager, processor_) {}
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SerializeFromKey(index_key, key, key_schema_, row_id);
 
   bool status = container_.Insert(index_key, row_id, txn);
   delete index_key;
@@ -29,7 +29,7 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
 
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SerializeFromKey(index_key, key, key_schema_, row_id);
 
   container_.Remove(index_key, txn);
   delete index_key;
@@ -42,11 +42,11 @@ dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transacti
   if (compare_operator == "=") {
     container_.GetValue(index_key, result, txn);
   } else if (compare_operator == ">") {
+    /* 跳过与key相等的项，非唯一索引可能有多项 */
     auto iter = GetBeginIterator(index_key),
          end = GetEndIterator();
-    if (container_.GetValue(index_key, result, txn))
+    while (iter != end && processor_.CompareColumns(index_key, (*iter).first) == 0)
       ++iter;
-    result.clear();
 
     for (; iter != end; ++iter) {
       result.emplace_back((*iter).second);
@@ -0,0 +1,71 @@
+#include "index/key_search.h"
+
+#include <immintrin.h>
+
+#include <climits>
+
+/* 按CPUID选用最宽的可用内核 */
+static KeySearch::CountLessFunc SelectCountLess() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return KeySearch::CountLessAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return KeySearch::CountLessSse42;
+  }
+  return KeySearch::CountLessScalar;
+}
+
+KeySearch::CountLessFunc KeySearch::count_less_ = SelectCountLess();
+
+const char *KeySearch::GetKernelName() {
+  if (count_less_ == CountLessAvx2) {
+    return "avx2";
+  }
+  return count_less_ == CountLessSse42 ? "sse4.2" : "scalar";
+}
+
+int KeySearch::CountLessScalar(const char *keys, int stride, int n, uint64_t probe) {
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    count += WordKeyComparator::Load(keys + i * stride) < probe;
+  }
+  return count;
+}
+
+__attribute__((target("sse4.2"))) int KeySearch::CountLessSse42(const char *keys, int stride, int n,
+                                                                 uint64_t probe) {
+  /* 1. 两个键一组：字节反转成大端值，翻转符号位后用有符号比较 */
+  const __m128i reverse = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const __m128i sign = _mm_set1_epi64x(LLONG_MIN);
+  const __m128i target = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(probe)), sign);
+  int count = 0, i = 0;
+  for (; i + 2 <= n; i += 2) {
+    long long lo, hi;
+    memcpy(&lo, keys + i * stride, sizeof(lo));
+    memcpy(&hi, keys + (i + 1) * stride, sizeof(hi));
+    __m128i words = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x(hi, lo), reverse), sign);
+    count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target, words))));
+  }
+
+  /* 2. 余下的键逐个比较 */
+  return count + CountLessScalar(keys + i * stride, stride, n - i, probe);
+}
+
+__attribute__((target("avx2"))) int KeySearch::CountLessAvx2(const char *keys, int stride, int n, uint64_t probe) {
+  /* 1. 四个键一组按步长gather，字节反转成大端值，翻转符号位后用有符号比较 */
+  const __m256i reverse = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                           15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i sign = _mm256_set1_epi64x(LLONG_MIN);
+  const __m256i target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(probe)), sign);
+  const __m256i offsets = _mm256_setr_epi64x(0, stride, 2LL * stride, 3LL * stride);
+  int count = 0, i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i words = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(keys + i * stride), offsets, 1);
+    words = _mm256_xor_si256(_mm256_shuffle_epi8(words, reverse), sign);
+    count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, words))));
+  }
+
+  /* 2. 余下的键逐个比较 */
+  return count + CountLessScalar(keys + i * stride, stride, n - i, probe);
+}
@@ -1,6 +1,7 @@
 #include "page/b_plus_tree_internal_page.h"
 
 #include "index/generic_key.h"
+#include "index/key_search.h"
 
 #define pairs_off (data_ + INTERNAL_PAGE_HEADER_SIZE)
 #define pair_size (GetKeySize() + sizeof(page_id_t))
@@ -73,25 +74,15 @@ void InternalPage::PairCopy(void *dest, void *src, int pair_num) {
  * 用了二分查找
  */
 page_id_t InternalPage::Lookup(const GenericKey *key, const KeyManager &KM) {
-  int L = 1, R = GetSize() - 1, M;
-
-  while(L <= R)
-  {
-    M = (L+R)/2;  // 中间项
-
-    int direction = KM.CompareKeys(key, KeyAt(M));  // 判断中间项与key的大小关系
-
-    /* 按照不同比较情况决定新的二分范围
-     * ！对于B+树来说：比键值小的值所在节点在左侧，大于等于其的节点在右侧！*/
-    if(direction == -1)     // key小于中间项
-      R = M - 1;
-    else if(direction == 1) // key大于中间项
-      L = M + 1;
-    else                    // key等于中间项（右侧指针）
-      return ValueAt(M);
-  }
+  /* 按索引创建时选定的比较器展开二分查找 */
+  return KM.WithComparator([&](const auto &comparator) { return Lookup(key, comparator); });
+}
 
-  return ValueAt(R);  // L一定在最后会大于R（L = R + 1），所以返回R（考虑到可能会是Value(0)）
+template <typename Comparator>
+page_id_t InternalPage::Lookup(const GenericKey *key, const Comparator &comparator) {
+  /* 第一个键无效，从第二个键起数出不大于key的键数，即为所在子节点的下标 */
+  return ValueAt(
+      KeySearch::UpperBound(reinterpret_cast<const char *>(KeyAt(1)), pair_size, GetSize() - 1, key, comparator));
 }
 
 /*****************************************************************************
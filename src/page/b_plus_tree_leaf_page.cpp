@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "index/generic_key.h"
+#include "index/key_search.h"
 
 #define pairs_off (data_ + LEAF_PAGE_HEADER_SIZE)
 #define pair_size (GetKeySize() + sizeof(RowId))
@@ -55,24 +56,14 @@ void LeafPage::SetNextPageId(page_id_t next_page_id) {
  * 二分查找
  */
 int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
-    int L = 0, R = GetSize() - 1, M;
-
-    while(L <= R)
-    {
-        M = (L + R)/2;  // 中间项
-        int direction = KM.CompareKeys(key, KeyAt(M));  // 判断中间项与key的大小关系
-
-        /* 按照不同比较情况决定新的二分范围
-         * ！对于B+树来说：比键值小的值所在节点在左侧，大于等于其的节点在右侧！*/
-        if(direction == -1)     // key小于中间项
-            R = M - 1;
-        else if(direction == 1) // key大于中间项
-            L = M + 1;
-        else                    // key等于中间项（右侧指针）
-            return M;
-    }
+    /* 按索引创建时选定的比较器展开二分查找 */
+    return KM.WithComparator([&](const auto &comparator) { return KeyIndex(key, comparator); });
+}
 
-    return L;
+template <typename Comparator>
+int LeafPage::KeyIndex(const GenericKey *key, const Comparator &comparator) {
+    /* 键唯一，第一个不小于key的位置即相等项或key应插入的位置 */
+    return KeySearch::LowerBound(reinterpret_cast<const char *>(KeyAt(0)), pair_size, GetSize(), key, comparator);
 }
 
 /*
@@ -195,6 +186,8 @@ bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM)
  */
 int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM) {
     int index = KeyIndex(key, KM);
+    if(index >= GetSize() || KM.CompareKeys(key, KeyAt(index)) != 0)  // key不存在
+        return GetSize();
     int size = GetSize() - 1;
 
     // 从左向右开始更新leaf node
@@ -1,5 +1,7 @@
 #include "page/bitmap_page.h"
 
+#include <cstring>
+
 #include "glog/logging.h"
 
 /**
@@ -7,26 +9,26 @@
  */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
-  /* 判断该位置是否有bitmap映射（该bit是否为0）*/
-  page_offset = next_free_page_;
-  if (IsPageFree(page_offset)) {
-    /* 用位或方法添加1，总page数+1 */
-    bytes[page_offset / 8] |= 1 << (page_offset % 8);
-    page_allocated_++;
-
-    /* 找新的free_page——暂定线性搜索 */
-    for(int i = 0; i < MAX_CHARS*8 && page_allocated_ < MAX_CHARS*8; i++)
-    {
-      if(IsPageFree(i)) {
-        next_free_page_ = i;
-        break;
-      }
-    }
+  /* 1. extent已满则无法分配 */
+  if (page_allocated_ >= GetMaxSupportedSize()) {
+    return false;
+  }
 
-    return true;
+  /* 2. next_free_page_ 失效时（如旧版本写下的bitmap）重新查找 */
+  if (!IsPageFree(next_free_page_)) {
+    next_free_page_ = FindFreePage(next_free_page_);
   }
 
-  return false;
+  /* 3. 用位或方法添加1，总page数+1 */
+  page_offset = next_free_page_;
+  bytes[page_offset / 8] |= 1 << (page_offset % 8);
+  page_allocated_++;
+
+  /* 4. 从当前位置向后按字查找新的free_page */
+  if (page_allocated_ < GetMaxSupportedSize()) {
+    next_free_page_ = FindFreePage(page_offset + 1);
+  }
+  return true;
 }
 
 /**
@@ -66,6 +68,32 @@ bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index)
   return (((bytes[byte_index] >> bit_index) & 1) == 0);
 }
 
+/**
+ * 按64位字扫描：page i 存放在 bytes[i / 8] 的第 i % 8 位，小端序下恰好是第 i / 64 个字的第 i % 64 位，
+ * 因此对取反后的字做 ctz 即可得到字内第一个空闲页。
+ */
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindFreePage(uint32_t start) const {
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "Bitmap is not made of whole words.");
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Word scan assumes little endian.");
+  constexpr uint32_t num_words = MAX_CHARS / sizeof(uint64_t);
+  start %= GetMaxSupportedSize();
+  uint32_t word_index = start / 64;
+  // skip the pages before start in the first word, they are checked last after wrapping around
+  uint64_t mask = ~uint64_t{0} << (start % 64);
+  for (uint32_t i = 0; i <= num_words; i++) {
+    uint64_t word;
+    memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+    uint64_t free_bits = ~word & mask;
+    if (free_bits != 0) {
+      return word_index * 64 + __builtin_ctzll(free_bits);
+    }
+    mask = ~uint64_t{0};
+    word_index = (word_index + 1) % num_words;
+  }
+  return GetMaxSupportedSize();
+}
+
 template class BitmapPage<64>;
 
 template class BitmapPage<128>;
@@ -1,18 +1,47 @@
 #include "page/table_page.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn) {
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
   SetTupleCount(0);
+  memcpy(GetData() + OFFSET_FORMAT, &FORMAT_LIVE_SLOTS, sizeof(uint16_t));
+  memset(GetData() + OFFSET_LIVE_SLOTS, 0, SIZE_LIVE_SLOTS);
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager,
                             LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  uint32_t i;
+  if (!ReserveTuple(serialized_size, &i)) {
+    return false;
+  }
+  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetTupleOffsetAtSlot(i), schema);
+  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
+  // Set rid
+  row.SetRowId(RowId(GetTablePageId(), i));
+  return true;
+}
+
+bool TablePage::InsertTuple(const char *data, uint32_t size, RowId *rid) {
+  ASSERT(size > 0, "Can not have empty row.");
+  uint32_t i;
+  if (!ReserveTuple(size, &i)) {
+    return false;
+  }
+  memcpy(GetData() + GetTupleOffsetAtSlot(i), data, size);
+  rid->Set(GetTablePageId(), i);
+  return true;
+}
+
+bool TablePage::ReserveTuple(uint32_t size, uint32_t *slot_num) {
+  if (GetFreeSpaceRemaining() < size) {
     return false;
   }
   // Try to find a free slot to reuse.
@@ -24,22 +53,21 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn, LockMana
       break;
     }
   }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  // A reused slot needs no room for a new slot entry.
+  if (i == GetTupleCount() && GetFreeSpaceRemaining() < size + SIZE_TUPLE) {
     return false;
   }
   // Otherwise we claim available free space..
-  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
-  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
-  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
+  SetFreeSpacePointer(GetFreeSpacePointer() - size);
 
   // Set the tuple.
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
-  SetTupleSize(i, serialized_size);
-  // Set rid
-  row.SetRowId(RowId(GetTablePageId(), i));
+  SetTupleSize(i, size);
+  SetLive(i, true);
   if (i == GetTupleCount()) {
     SetTupleCount(GetTupleCount() + 1);
   }
+  *slot_num = i;
   return true;
 }
 
@@ -58,6 +86,7 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   if (tuple_size > 0) {
     SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
   }
+  SetLive(slot_num, false);
   return true;
 }
 
@@ -84,6 +113,11 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema, Tr
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  // A tuple of the same size is overwritten where it is.
+  if (serialized_size == tuple_size) {
+    new_row.SerializeTo(GetData() + tuple_offset, schema);
+    return true;
+  }
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
   memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
@@ -96,7 +130,7 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema, Tr
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
     if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - serialized_size);
     }
   }
 
@@ -122,6 +156,7 @@ void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_
   SetFreeSpacePointer(free_space_pointer + tuple_size);
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
+  SetLive(slot_num, false);
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -141,6 +176,7 @@ void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *l
   if (IsDeleted(tuple_size)) {
     SetTupleSize(slot_num, UnsetDeletedFlag(tuple_size));
   }
+  SetLive(slot_num, GetTupleSize(slot_num) != 0);
 }
 
 bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager) {
@@ -166,11 +202,10 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
 
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
-  for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
-      first_rid->Set(GetTablePageId(), i);
-      return true;
-    }
+  uint32_t slot_num = FindLiveSlot(0);
+  if (slot_num < GetTupleCount()) {
+    first_rid->Set(GetTablePageId(), slot_num);
+    return true;
   }
   first_rid->Set(INVALID_PAGE_ID, 0);
   return false;
@@ -179,13 +214,88 @@ bool TablePage::GetFirstTupleRid(RowId *first_rid) {
 bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
-  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
-      next_rid->Set(GetTablePageId(), i);
-      return true;
-    }
+  uint32_t slot_num = FindLiveSlot(cur_rid.GetSlotNum() + 1);
+  if (slot_num < GetTupleCount()) {
+    next_rid->Set(GetTablePageId(), slot_num);
+    return true;
   }
   // Otherwise return false as there are no more tuples.
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+uint32_t TablePage::FindLiveSlot(uint32_t slot_num) {
+  uint32_t tuple_count = GetTupleCount();
+  if (slot_num >= tuple_count) {
+    return tuple_count;
+  }
+  // A page in the former layout has no bitmap, its slot array is read instead.
+  if (!HasLiveSlots()) {
+    while (slot_num < tuple_count && IsDeleted(GetTupleSize(slot_num))) {
+      slot_num++;
+    }
+    return slot_num;
+  }
+  auto *words = reinterpret_cast<const uint64_t *>(GetData() + OFFSET_LIVE_SLOTS);
+  // Mask off the slots before slot_num in its word, then skip whole words of dead slots.
+  uint32_t word = slot_num / 64;
+  uint64_t bits = words[word] & (~uint64_t{0} << (slot_num % 64));
+  uint32_t num_words = (tuple_count + 63) / 64;
+  while (bits == 0) {
+    if (++word == num_words) {
+      return tuple_count;
+    }
+    bits = words[word];
+  }
+  return std::min<uint32_t>(word * 64 + __builtin_ctzll(bits), tuple_count);
+}
+
+uint32_t TablePage::GetLiveTupleCount() {
+  if (!HasLiveSlots()) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < GetTupleCount(); i++) {
+      count += !IsDeleted(GetTupleSize(i));
+    }
+    return count;
+  }
+  auto *words = reinterpret_cast<const uint64_t *>(GetData() + OFFSET_LIVE_SLOTS);
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < (GetTupleCount() + 63) / 64; i++) {
+    count += __builtin_popcountll(words[i]);
+  }
+  return count;
+}
+
+uint32_t TablePage::Compact() {
+  uint32_t old_free_space = GetFreeSpaceRemaining();
+
+  // Collect the slots in use, ordered by their offset from the end of the page.
+  std::vector<std::pair<uint32_t, uint32_t>> slots;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) != 0) {
+      slots.emplace_back(GetTupleOffsetAtSlot(i), i);
+    }
+  }
+  std::sort(slots.begin(), slots.end(), std::greater<>());
+
+  // Move every tuple body right behind the one after it, closing the gaps in between.
+  uint32_t free_space_pointer = PAGE_SIZE;
+  for (auto &slot : slots) {
+    uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(slot.second));
+    free_space_pointer -= tuple_size;
+    if (free_space_pointer != slot.first) {
+      memmove(GetData() + free_space_pointer, GetData() + slot.first, tuple_size);
+      SetTupleOffsetAtSlot(slot.second, free_space_pointer);
+    }
+  }
+  SetFreeSpacePointer(free_space_pointer);
+
+  // Empty slots at the end are not referenced by any row id and can be dropped.
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+
+  return GetFreeSpaceRemaining() - old_free_space;
+}
@@ -49,7 +49,9 @@ AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> stateme
     }
   }
   if (available_index.empty() || statement->has_or) {
-    return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+    auto scan_plan = make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+    scan_plan->SetParallel(true);
+    return scan_plan;
   }
   return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index,
                                         available_index.size() != statement->column_in_condition_.size(),
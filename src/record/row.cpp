@@ -1,5 +1,9 @@
 #include "record/row.h"
 
+#include <new>
+
+#include "record/row_view.h"
+
 /**
  * TODO: Student Implement
  */
@@ -7,15 +11,15 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   /* Row结构：
    * rid_          : sizeof(RowId)
    * fields_大小    : uint32_t
-   * fields_是否为空 : fields_.size() 个 *bit*
+   * fields_是否为空 : field_count_ 个 *bit*
    * fields_       : Fields::SerializeTo() */
 
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
-  ASSERT(schema->GetColumnCount() == fields_.size(),
+  ASSERT(schema->GetColumnCount() == field_count_,
          "Fields size do not match schema's column size.");
 
   uint32_t ofs = 0;
-  uint32_t vctSize = fields_.size();
+  uint32_t vctSize = field_count_;
   // std::vector<bool> null_indicator;
 
   //  /* rid_ */
@@ -29,7 +33,7 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   /* fields_是否为空：位图方法 0 : notNull 1 : isNull
    * !注释版本有空间浪费 */
   // for(uint32_t i = 0; i < vctSize; i++) {
-  //   if (fields_[i]->IsNull()) MACH_WRITE_TO(bool, buf + ofs, true);
+  //   if (GetField(i)->IsNull()) MACH_WRITE_TO(bool, buf + ofs, true);
   //   else MACH_WRITE_TO(bool, buf + ofs, false);
   //   ofs += sizeof(bool);
   // }
@@ -37,7 +41,7 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   memset(nullBMap, 0, sizeof(nullBMap));
   for(uint32_t i = 0; i < vctSize; i++)
   {
-    if(fields_[i]->IsNull())
+    if(GetField(i)->IsNull())
       nullBMap[i/8] |= 1 << (i % 8);
   }
   memcpy(buf + ofs, nullBMap, sizeof(nullBMap));
@@ -45,72 +49,51 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
 
   /* fields_——非空写 */
   for(uint32_t i = 0; i < vctSize; i++)
-    if(!fields_[i]->IsNull())
-      ofs += fields_[i]->SerializeTo(buf + ofs);
+    if(!GetField(i)->IsNull())
+      ofs += GetField(i)->SerializeTo(buf + ofs);
 
   return ofs;
 }
 
-uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  /* Row结构：
-   * rid_          : sizeof(RowId)
-   * fields_大小    : uint32_t
-   * fields_是否为空 : fields_.size() 个 *bit*
-   * fields_       : Fields::SerializeTo() */
-
+uint32_t Row::SerializeTo(char *buf, Schema *schema, const std::vector<page_id_t> &overflow_pages) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
-  // ASSERT(fields_.empty(), "Non empty field in row.");
-
-  uint32_t ofs = 0;
-  uint32_t vctSize;
-  std::vector<bool> null_indicator;
-
-  //  /* rid_ */
-  //  rid_ = MACH_READ_FROM(RowId, buf + ofs);
-  //  ofs += sizeof(RowId);
-
-  /* fields_大小 */
-  vctSize = MACH_READ_UINT32(buf + ofs);
-  ofs += sizeof(uint32_t);
-
-  /* ! fields_是否为空（位图）—— 0：notNull 1：isNull */
-  null_indicator.resize(vctSize);
-  uint8_t nullBMap[vctSize/8+1];
-  memcpy(nullBMap, buf + ofs, sizeof(nullBMap));
-  // for (uint32_t i = 0; i < vctSize; i++) {
-  //   null_indicator[i] = MACH_READ_FROM(bool, buf + ofs);
-  //   ofs += sizeof(bool);
-  // }
-  for(uint32_t i = 0; i < vctSize; i++)
-    null_indicator[i] = nullBMap[i/8] & (1 << (i % 8));
-  ofs += sizeof(nullBMap);
-
-  /* fields_ —— 非空读 */
-  fields_.resize(vctSize);
+  ASSERT(schema->GetColumnCount() == field_count_, "Fields size do not match schema's column size.");
+  ASSERT(overflow_pages.size() == field_count_, "Overflow pages do not match fields.");
+  /* 头部与非溢出字段同SerializeTo，溢出字段只写长度（带标志位）和溢出链首页 */
+  uint32_t vctSize = field_count_;
+  uint32_t ofs = sizeof(uint32_t) + vctSize / 8 + 1;
+  MACH_WRITE_UINT32(buf, vctSize);
+  memset(buf + sizeof(uint32_t), 0, vctSize / 8 + 1);
   for (uint32_t i = 0; i < vctSize; i++) {
-    /* 对空值属性的空间分配（只对vector分配，不对row物理空间分配）*/
-    if (null_indicator[i]) fields_[i] = new Field((schema->GetColumn(i))->GetType());
-    /* 对非空值属性的空间分配（对vector和row物理空间分配）*/
-    else {
-      TypeId type = schema->GetColumn(i)->GetType();
-      ofs += Field::DeserializeFrom(buf + ofs, type, &fields_[i],
-                                    null_indicator[i]);
+    if (GetField(i)->IsNull()) {
+      buf[sizeof(uint32_t) + i / 8] |= 1 << (i % 8);
+    } else if (overflow_pages[i] != INVALID_PAGE_ID) {
+      MACH_WRITE_UINT32(buf + ofs, GetField(i)->GetLength() | OVERFLOW_FLAG);
+      MACH_WRITE_TO(page_id_t, buf + ofs + sizeof(uint32_t), overflow_pages[i]);
+      ofs += SIZE_OVERFLOW_FIELD;
+    } else {
+      ofs += GetField(i)->SerializeTo(buf + ofs);
     }
   }
-
-  null_indicator.clear();
-  // null_indicator.shrink_to_fit();
-
   return ofs;
 }
 
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
+  /* 与RowView共用解析逻辑：先求字符串总长，再一次性拷入行缓冲 */
+  ASSERT(schema != nullptr, "Invalid schema before serialize.");
+  RowView view;
+  view.Reset(buf, schema, rid_);
+  view.ToRow(this);
+  return view.GetSerializedSize();
+}
+
 uint32_t Row::GetSerializedSize(Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
-  ASSERT(schema->GetColumnCount() == fields_.size(),
+  ASSERT(schema->GetColumnCount() == field_count_,
          "Fields size do not match schema's column size.");
 
   uint32_t ofs = 0;
-  uint32_t vctSize = fields_.size();
+  uint32_t vctSize = field_count_;
 
   //  /* rid_ */
   //  ofs += sizeof(RowId);
@@ -124,19 +107,94 @@ uint32_t Row::GetSerializedSize(Schema *schema) const {
 
   /* fields */
   for(uint32_t i = 0; i < vctSize; i++)
-    if(!fields_[i]->IsNull())
-      ofs += fields_[i]->GetSerializedSize();
+    if(!GetField(i)->IsNull())
+      ofs += GetField(i)->GetSerializedSize();
 
   return ofs;
 }
 
+uint32_t Row::GetSerializedSize(Schema *schema, const std::vector<page_id_t> &overflow_pages) const {
+  ASSERT(schema != nullptr, "Invalid schema before serialize.");
+  ASSERT(schema->GetColumnCount() == field_count_, "Fields size do not match schema's column size.");
+  ASSERT(overflow_pages.size() == field_count_, "Overflow pages do not match fields.");
+  uint32_t size = sizeof(uint32_t) + field_count_ / 8 + 1;
+  for (uint32_t i = 0; i < field_count_; i++) {
+    if (GetField(i)->IsNull()) continue;
+    size += overflow_pages[i] != INVALID_PAGE_ID ? SIZE_OVERFLOW_FIELD : GetField(i)->GetSerializedSize();
+  }
+  return size;
+}
+
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
+  /* key_row可能就是本行，先建在临时行中再移入 */
   auto columns = key_schema->GetColumns(0);
-  std::vector<Field> fields;
-  uint32_t idx;
-  for (auto column : columns) {
-    schema->GetColumnIndex(column->GetName(), idx);
-    fields.emplace_back(*this->GetField(idx));
+  std::vector<uint32_t> idxs(columns.size());
+  uint32_t varlen_size = 0;
+  for (size_t i = 0; i < columns.size(); i++) {
+    schema->GetColumnIndex(columns[i]->GetName(), idxs[i]);
+    varlen_size += GetVarlenSize(*GetField(idxs[i]));
+  }
+  Row key(rid_);
+  key.Init(idxs.size(), varlen_size);
+  for (size_t i = 0; i < idxs.size(); i++) {
+    key.SetField(i, *GetField(idxs[i]));
+  }
+  key_row = std::move(key);
+}
+
+int Row::CompareTo(const Row &other) const {
+  for (size_t i = 0; i < field_count_; i++) {
+    const Field *fa = GetField(i), *fb = other.GetField(i);
+    /* null排在所有值之前 */
+    if (fa->IsNull() || fb->IsNull()) {
+      if (fa->IsNull() != fb->IsNull()) return fa->IsNull() ? -1 : 1;
+      continue;
+    }
+    if (fa->CompareLessThan(*fb) == CmpBool::kTrue) return -1;
+    if (fa->CompareGreaterThan(*fb) == CmpBool::kTrue) return 1;
+  }
+  return 0;
+}
+
+void Row::Init(uint32_t field_count, uint32_t varlen_size) {
+  /* 1. 槽区在前、变长区在后，原缓冲够大时直接复用 */
+  uint32_t size = field_count * sizeof(Field) + varlen_size;
+  if (size > capacity_) {
+    buffer_.reset(new char[size]);
+    capacity_ = size;
+  }
+  field_count_ = field_count;
+  varlen_size_ = 0;
+
+  /* 2. 字段先全部置空。槽中的字段都不持有数据，无需析构 */
+  for (uint32_t i = 0; i < field_count; i++) {
+    new (GetField(i)) Field(TypeId::kTypeInvalid);
+  }
+}
+
+void Row::SetField(uint32_t idx, const Field &field) {
+  Field *slot = GetField(idx);
+  if (field.IsNull()) {
+    new (slot) Field(field.GetTypeId());
+    return;
+  }
+  if (field.GetTypeId() != TypeId::kTypeChar) {
+    new (slot) Field(field);
+    return;
+  }
+
+  /* 字符串拷入变长区，槽中字段只指向它 */
+  uint32_t len = field.GetLength();
+  char *data = buffer_.get() + field_count_ * sizeof(Field) + varlen_size_;
+  ASSERT(field_count_ * sizeof(Field) + varlen_size_ + len <= capacity_, "Row buffer overflow.");
+  memcpy(data, field.GetData(), len);
+  varlen_size_ += len;
+  new (slot) Field(TypeId::kTypeChar, data, len, false);
+}
+
+void Row::CopyFields(const Row &other) {
+  Init(other.field_count_, other.varlen_size_);
+  for (uint32_t i = 0; i < field_count_; i++) {
+    SetField(i, *other.GetField(i));
   }
-  key_row = Row(fields);
 }
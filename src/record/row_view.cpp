@@ -0,0 +1,133 @@
+#include "record/row_view.h"
+
+#include <algorithm>
+
+RowProjection::RowProjection(const Schema *schema, const std::vector<uint32_t> &columns) {
+  /* 1. 只需记录到最后一个读取的列为止 */
+  uint32_t count = columns.empty() ? 0 : *std::max_element(columns.begin(), columns.end()) + 1;
+  sizes_.resize(count);
+  slots_.assign(count, -1);
+  for (uint32_t i = 0; i < count; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    sizes_[i] = type == TypeId::kTypeChar ? 0 : Type::GetTypeSize(type);
+  }
+
+  /* 2. 按表中的顺序为读取的列编号 */
+  for (uint32_t idx : columns) {
+    slots_[idx] = 0;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (slots_[i] >= 0) slots_[i] = column_count_++;
+  }
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  const char *buf = data_ + GetFieldOffset(idx);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_FROM(int32_t, buf));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float_t, buf));
+    default: {
+      /* 字符串直接指向页内数据，不拷贝；溢出的字符串此时才读出 */
+      uint32_t len = MACH_READ_UINT32(buf);
+      if (len & Row::OVERFLOW_FLAG) {
+        return Field(type, ReadOverflow(buf), len & ~Row::OVERFLOW_FLAG, false);
+      }
+      return Field(type, const_cast<char *>(buf + sizeof(uint32_t)), len, false);
+    }
+  }
+}
+
+bool RowView::IsOverflow(uint32_t idx) const {
+  if (IsNull(idx) || schema_->GetColumn(idx)->GetType() != TypeId::kTypeChar) {
+    return false;
+  }
+  return MACH_READ_UINT32(data_ + GetFieldOffset(idx)) & Row::OVERFLOW_FLAG;
+}
+
+char *RowView::ReadOverflow(const char *buf) const {
+  ASSERT(overflow_reader_ != nullptr, "Row view can not read overflow pages.");
+  uint32_t len = MACH_READ_UINT32(buf) & ~Row::OVERFLOW_FLAG;
+  overflow_data_.emplace_back(new char[len]);
+  (*overflow_reader_)(MACH_READ_FROM(page_id_t, buf + sizeof(uint32_t)), len, overflow_data_.back().get());
+  return overflow_data_.back().get();
+}
+
+void RowView::ToRow(Row *row) const {
+  std::vector<uint32_t> columns(GetFieldCount());
+  for (uint32_t i = 0; i < columns.size(); i++) {
+    columns[i] = i;
+  }
+  ToRow(columns, row);
+}
+
+void RowView::ToRow(const std::vector<uint32_t> &columns, Row *row) const {
+  /* 1. 先由长度字求出字符串总长，整行只需一块缓冲 */
+  uint32_t varlen_size = 0;
+  for (uint32_t idx : columns) {
+    if (!IsNull(idx) && schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar) {
+      varlen_size += MACH_READ_UINT32(data_ + GetFieldOffset(idx)) & ~Row::OVERFLOW_FLAG;
+    }
+  }
+
+  /* 2. 逐个字段拷入行缓冲，溢出的字符串此时才读出 */
+  row->SetRowId(rid_);
+  row->Init(columns.size(), varlen_size);
+  for (size_t i = 0; i < columns.size(); i++) {
+    row->SetField(i, GetField(columns[i]));
+  }
+}
+
+uint32_t RowView::GetFieldOffset(uint32_t idx) const {
+  /* 0. 给定了读取的列时，一趟解出这些列的偏移 */
+  if (projection_ != nullptr) {
+    ASSERT(projection_->Contains(idx), "Column is not read by the projection of the row view.");
+    if (offsets_.empty()) DecodeProjection();
+    return offsets_[projection_->slots_[idx]];
+  }
+
+  /* 1. 首个字段紧跟在字段数和空值位图之后 */
+  if (offsets_.empty()) {
+    offsets_.push_back(sizeof(uint32_t) + GetFieldCount() / 8 + 1);
+  }
+
+  /* 2. 从已解析的最后一个字段往后推进，空值字段不占空间 */
+  while (offsets_.size() <= idx) {
+    uint32_t i = offsets_.size() - 1;
+    uint32_t size = 0;
+    if (!IsNull(i)) {
+      TypeId type = schema_->GetColumn(i)->GetType();
+      if (type != TypeId::kTypeChar) {
+        size = Type::GetTypeSize(type);
+      } else {
+        uint32_t len = MACH_READ_UINT32(data_ + offsets_[i]);
+        size = (len & Row::OVERFLOW_FLAG) ? Row::SIZE_OVERFLOW_FIELD : sizeof(uint32_t) + len;
+      }
+    }
+    offsets_.push_back(offsets_[i] + size);
+  }
+  return offsets_[idx];
+}
+
+void RowView::DecodeProjection() const {
+  /* 未读取的列按预先算好的定长跳过，只有字符串需要读出长度字 */
+  uint32_t offset = sizeof(uint32_t) + GetFieldCount() / 8 + 1;
+  offsets_.resize(projection_->column_count_);
+  for (uint32_t i = 0; i < projection_->sizes_.size(); i++) {
+    if (projection_->slots_[i] >= 0) {
+      offsets_[projection_->slots_[i]] = offset;
+    }
+    if (IsNull(i)) continue;
+    uint32_t size = projection_->sizes_[i];
+    if (size == 0) {
+      uint32_t len = MACH_READ_UINT32(data_ + offset);
+      size = (len & Row::OVERFLOW_FLAG) ? Row::SIZE_OVERFLOW_FIELD : sizeof(uint32_t) + len;
+    }
+    offset += size;
+  }
+}
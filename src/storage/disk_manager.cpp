@@ -1,100 +1,349 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <filesystem>
+#include <memory>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, bool read_only, bool checksums)
+    : file_name_(db_file), direct_io_(direct_io && !read_only), read_only_(read_only) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
+  if (read_only_) {
+    db_fd_ = open(db_file.c_str(), O_RDONLY);
+    if (db_fd_ < 0) {
       throw std::exception();
     }
+    if (checksums) {
+      // a database written without checksums has no side file and is read unverified
+      crc_fd_ = open((db_file + ".crc").c_str(), O_RDONLY);
+    }
+    struct stat stat_buf;
+    file_size_ = fstat(db_fd_, &stat_buf) == 0 ? stat_buf.st_size : 0;
+    mapping_size_ = file_size_ / PAGE_SIZE * PAGE_SIZE;
+    if (mapping_size_ > 0) {
+      void *mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, db_fd_, 0);
+      if (mapping == MAP_FAILED) {
+        LOG(ERROR) << "Failed to map " << db_file << ": " << strerror(errno);
+        throw std::exception();
+      }
+      mapping_ = static_cast<char *>(mapping);
+    }
+    ReadPhysicalPage(META_PAGE_ID, meta_data_);
+    return;
+  }
+  // directory does not exist
+  std::filesystem::path p = db_file;
+  if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  // create a new file if needed
+  int flags = O_RDWR | O_CREAT;
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG(WARNING) << "O_DIRECT is not supported for " << db_file << ", fall back to buffered I/O";
+      direct_io_ = false;
+    }
   }
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw std::exception();
+  }
+  if (checksums) {
+    crc_fd_ = open((db_file + ".crc").c_str(), flags, 0644);
+    if (crc_fd_ < 0) {
+      throw std::exception();
+    }
+  }
+  struct stat stat_buf;
+  file_size_ = fstat(db_fd_, &stat_buf) == 0 ? stat_buf.st_size : 0;
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  for (uint32_t i = 0; i < meta_page->GetExtentNums(); i++) {
+    if (meta_page->GetExtentUsedPage(i) < BITMAP_SIZE) {
+      free_extents_.insert(i);
+    }
+  }
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
   if (!closed) {
-    db_io_.close();
+    StopAsyncWorkers();
+    if (read_only_) {
+      if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+      }
+    } else {
+      FlushBitmaps();
+      WritePhysicalPage(META_PAGE_ID, meta_data_);
+    }
+    close(db_fd_);
+    db_fd_ = -1;
+    if (crc_fd_ >= 0) {
+      close(crc_fd_);
+      crc_fd_ = -1;
+    }
     closed = true;
   }
 }
 
-void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+void DiskManager::FlushMetadata() {
+  if (read_only_) {
+    return;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (closed) {
+    return;
+  }
+  FlushBitmaps();
+  if (meta_dirty_) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+    meta_dirty_ = false;
+  }
+}
+
+bool DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+  if (num_pending_writes_ > 0) {
+    // the file is behind an asynchronous write of this page, serve its data
+    std::scoped_lock<std::mutex> lock(async_latch_);
+    auto iter = pending_writes_.find(logical_page_id);
+    if (iter != pending_writes_.end()) {
+      memcpy(page_data, iter->second.data.get(), PAGE_SIZE);
+      return true;
+    }
+  }
+  return ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  ASSERT(!read_only_, "Database is opened read-only.");
+  if (num_pending_writes_ > 0) {
+    bool pending;
+    {
+      std::scoped_lock<std::mutex> lock(async_latch_);
+      pending = pending_writes_.count(logical_page_id) != 0;
+    }
+    // queue behind the asynchronous writes of this page so that they can not overwrite this one
+    if (pending) {
+      WritePageAsync(logical_page_id, page_data).wait();
+      return;
+    }
+  }
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+char *DiskManager::GetPageView(page_id_t logical_page_id) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  ASSERT(read_only_, "Page views are only available in read-only mode.");
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  if (offset + PAGE_SIZE > mapping_size_) {
+    return zero_page_;
+  }
+  if (crc_fd_ >= 0 && !VerifyChecksum(MapPageId(logical_page_id), mapping_ + offset)) {
+    return nullptr;
+  }
+  return mapping_ + offset;
+}
+
+std::future<void> DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data) {
+  return ReadPagesAsync({{logical_page_id, page_data}});
+}
+
+std::future<void> DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data) {
+  return WritePagesAsync({{logical_page_id, page_data}});
+}
+
+std::future<void> DiskManager::ReadPagesAsync(const std::vector<std::pair<page_id_t, char *>> &pages) {
+  if (stop_async_) {
+    // the workers are gone once the disk manager is closed, fall back to synchronous reads
+    for (auto &page : pages) {
+      ReadPage(page.first, page.second);
+    }
+    return SubmitAsync({});
+  }
+  std::vector<AsyncRequest> requests;
+  requests.reserve(pages.size());
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    requests.push_back({page.first, page.second, nullptr, nullptr});
+  }
+  return SubmitAsync(std::move(requests));
+}
+
+std::future<void> DiskManager::WritePagesAsync(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  ASSERT(!read_only_, "Database is opened read-only.");
+  if (stop_async_) {
+    for (auto &page : pages) {
+      WritePage(page.first, page.second);
+    }
+    return SubmitAsync({});
+  }
+  std::vector<AsyncRequest> requests;
+  requests.reserve(pages.size());
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    std::shared_ptr<char[]> data(new char[PAGE_SIZE]);
+    memcpy(data.get(), page.second, PAGE_SIZE);
+    auto &pending = pending_writes_[page.first];
+    pending.data = data;
+    pending.count++;
+    num_pending_writes_++;
+    requests.push_back({page.first, nullptr, std::move(data), nullptr});
+  }
+  // submit while holding async_latch_, so that requests of one page reach their worker in registration order
+  return SubmitAsync(std::move(requests));
+}
+
+std::future<void> DiskManager::SubmitAsync(std::vector<AsyncRequest> &&requests) {
+  auto batch = std::make_shared<AsyncBatch>(requests.size());
+  auto future = batch->done.get_future();
+  if (requests.empty()) {
+    batch->done.set_value();
+    return future;
+  }
+  std::call_once(async_start_flag_, [this] {
+    for (int i = 0; i < DISK_IO_THREADS; i++) {
+      async_workers_.emplace_back(new AsyncWorker);
+    }
+    for (auto &worker : async_workers_) {
+      worker->thread = std::thread(&DiskManager::AsyncWorkerLoop, this, worker.get());
+    }
+  });
+  for (auto &request : requests) {
+    request.batch = batch;
+    AsyncWorker *worker = async_workers_[request.page_id % async_workers_.size()].get();
+    {
+      std::scoped_lock<std::mutex> lock(worker->latch);
+      worker->queue.push_back(std::move(request));
+    }
+    worker->cv.notify_one();
+  }
+  return future;
+}
+
+void DiskManager::AsyncWorkerLoop(AsyncWorker *worker) {
+  while (true) {
+    AsyncRequest request;
+    {
+      std::unique_lock<std::mutex> lock(worker->latch);
+      worker->cv.wait(lock, [&] { return stop_async_ || !worker->queue.empty(); });
+      if (worker->queue.empty()) {
+        return;
+      }
+      request = std::move(worker->queue.front());
+      worker->queue.pop_front();
+    }
+
+    if (request.read_buf != nullptr) {
+      if (!ReadPage(request.page_id, request.read_buf)) {
+        request.batch->failed = true;
+      }
+    } else {
+      WritePhysicalPage(MapPageId(request.page_id), request.write_data.get());
+      std::scoped_lock<std::mutex> lock(async_latch_);
+      auto iter = pending_writes_.find(request.page_id);
+      if (--iter->second.count == 0) {
+        pending_writes_.erase(iter);
+      }
+      num_pending_writes_--;
+    }
+    if (--request.batch->remaining == 0) {
+      if (request.batch->failed) {
+        request.batch->done.set_exception(std::make_exception_ptr(std::runtime_error("Checksum mismatch")));
+      } else {
+        request.batch->done.set_value();
+      }
+    }
+  }
+}
+
+void DiskManager::StopAsyncWorkers() {
+  stop_async_ = true;
+  for (auto &worker : async_workers_) {
+    {
+      std::scoped_lock<std::mutex> lock(worker->latch);
+    }
+    worker->cv.notify_one();
+  }
+  for (auto &worker : async_workers_) {
+    worker->thread.join();
+  }
+  async_workers_.clear();
+}
+
+void DiskManager::WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  ASSERT(!read_only_, "Database is opened read-only.");
+  // coalesce runs of physically consecutive pages into one vectored write
+  std::vector<const char *> run;
+  page_id_t run_start = INVALID_PAGE_ID;
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    page_id_t physical_page_id = MapPageId(page.first);
+    if (!run.empty() && physical_page_id != run_start + static_cast<page_id_t>(run.size())) {
+      WritePhysicalPages(run_start, run.data(), run.size());
+      run.clear();
+    }
+    if (run.empty()) {
+      run_start = physical_page_id;
+    }
+    run.push_back(page.second);
+  }
+  if (!run.empty()) {
+    WritePhysicalPages(run_start, run.data(), run.size());
+  }
+}
+
 /**
  * TODO: Student Implement
  */
 page_id_t DiskManager::AllocatePage() {
+  ASSERT(!read_only_, "Database is opened read-only.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetMetaData());
-  uint32_t extentNums = meta_page->GetExtentNums(),
-           extentIndex = 0;
-  size_t pageSize = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  bool extent_found = false;
 
-  /* 1. 在已有extent中寻找是否有可存储的空位 */
-  for(; extentIndex < extentNums; extentIndex++)
-  {
-    if(meta_page->GetExtentUsedPage(extentIndex) < pageSize)
-    {
-      extent_found = true;
-      break;
-    }
+  /* 1. 取第一个有空位的extent，没有则新建extent */
+  uint32_t extentIndex;
+  if (!free_extents_.empty()) {
+    extentIndex = *free_extents_.begin();
+  } else {
+    extentIndex = meta_page->num_extents_;
+    ASSERT(static_cast<page_id_t>((extentIndex + 1) * BITMAP_SIZE) <= MAX_VALID_PAGE_ID, "Database file is full.");
+    meta_page->num_extents_++;
+    meta_page->extent_used_page_[extentIndex] = 0;
+    memset(GetExtentBitmap(extentIndex), 0, PAGE_SIZE);
+    free_extents_.insert(extentIndex);
   }
 
-  /* 2. 如果有可存储空位，在该extent中进行存储 */
+  /* 2. 在缓存的bitMap中分配页，bitMap由FlushMetadata或关闭时写回 */
   uint32_t ofs;
+  bool __attribute__((unused)) allocated = GetExtentBitmap(extentIndex)->AllocatePage(ofs);
+  ASSERT(allocated, "Extent bitmap disagrees with meta page.");
+  dirty_bitmaps_[extentIndex] = true;
+
+  /* 3. metaPage信息更新，extent已满则移出空闲集合 */
+  meta_dirty_ = true;
   meta_page->num_allocated_pages_++;
-  page_id_t BMAddr = (pageSize + 1) * extentIndex + 1 ;
-  // (pageSize+1): 包含BitMap; *extentIndex: 已有extent数-1; +1: 到当前BitMap
-  if(extent_found)
-  {
-    char currBMap[PAGE_SIZE];
-    /* 2.1. 读取该extent的bitMap */
-    ReadPhysicalPage(BMAddr, currBMap);
-    /* 2.2. 分配页空间 */
-    reinterpret_cast<BitmapPage<PAGE_SIZE> *>(currBMap)->AllocatePage(ofs);
-    /* 2.3. metaPage信息更新 */
-    meta_page->extent_used_page_[extentIndex]++;
-    /* 2.4. 写入新BMap */
-    WritePhysicalPage(BMAddr, currBMap);
-  }
-  /* 3. 未找到有空位的extent，新建extent */
-  else
-  {
-    char newBMap[PAGE_SIZE];
-    memset(newBMap, 0, sizeof(newBMap));
-    meta_page->num_extents_++;
-    meta_page->extent_used_page_[extentIndex]++;
-    reinterpret_cast<BitmapPage<PAGE_SIZE> *>(newBMap)->AllocatePage((uint32_t &)ofs);
-    WritePhysicalPage(BMAddr, newBMap);
+  if (++meta_page->extent_used_page_[extentIndex] == BITMAP_SIZE) {
+    free_extents_.erase(extentIndex);
   }
 
-  return ofs + pageSize * extentIndex;
+  return ofs + BITMAP_SIZE * extentIndex;
 }
 
 /**
@@ -102,26 +351,23 @@ page_id_t DiskManager::AllocatePage() {
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id)
 {
+  ASSERT(!read_only_, "Database is opened read-only.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetMetaData());
-  size_t pageSize = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  char currBMap[PAGE_SIZE];
-  uint32_t extentIndex = logical_page_id / pageSize,
-           ofs = logical_page_id % pageSize;
+  uint32_t extentIndex = logical_page_id / BITMAP_SIZE,
+           ofs = logical_page_id % BITMAP_SIZE;
 
-  ReadPhysicalPage((pageSize + 1) *extentIndex + 1, currBMap);
-
-  if(!reinterpret_cast<BitmapPage<PAGE_SIZE> *>(currBMap)->DeAllocatePage(ofs))
+  if(extentIndex >= meta_page->GetExtentNums() || !GetExtentBitmap(extentIndex)->DeAllocatePage(ofs))
   {
     // std::cout << "Deallocate Error" << std::endl;
     return;
   }
+  dirty_bitmaps_[extentIndex] = true;
 
-  WritePhysicalPage((pageSize + 1) * extentIndex + 1, currBMap);
-
+  meta_dirty_ = true;
   meta_page->num_allocated_pages_--;
   meta_page->extent_used_page_[extentIndex]--;
-
-  return;
+  free_extents_.insert(extentIndex);
 }
 
 /**
@@ -129,14 +375,36 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id)
  * 思路类似于Allocate方法：先找extent位置，找到对应BitMap的空判断函数来做判断
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  size_t pageSize = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-  char currBMap[PAGE_SIZE];
-  uint32_t extentIndex = logical_page_id / pageSize,
-           ofs = logical_page_id % pageSize;
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetMetaData());
+  uint32_t extentIndex = logical_page_id / BITMAP_SIZE,
+           ofs = logical_page_id % BITMAP_SIZE;
 
-  ReadPhysicalPage((pageSize + 1) *extentIndex + 1, currBMap);
+  if (extentIndex >= meta_page->GetExtentNums()) {
+    return true;
+  }
+  return GetExtentBitmap(extentIndex)->IsPageFree(ofs);
+}
 
-  return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(currBMap)->IsPageFree(ofs);
+BitmapPage<PAGE_SIZE> *DiskManager::GetExtentBitmap(uint32_t extent_id) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    dirty_bitmaps_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id].reset(new char[PAGE_SIZE]);
+    ReadPhysicalPage((BITMAP_SIZE + 1) * extent_id + 1, bitmaps_[extent_id].get());
+  }
+  return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmaps_[extent_id].get());
+}
+
+void DiskManager::FlushBitmaps() {
+  for (size_t i = 0; i < bitmaps_.size(); i++) {
+    if (dirty_bitmaps_[i]) {
+      WritePhysicalPage((BITMAP_SIZE + 1) * i + 1, bitmaps_[i].get());
+      dirty_bitmaps_[i] = false;
+    }
+  }
 }
 
 /**
@@ -152,45 +420,134 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
 }
 
 
-int DiskManager::GetFileSize(const std::string &file_name) {
-  struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? stat_buf.st_size : -1;
+char *DiskManager::BounceBuffer() {
+  thread_local std::unique_ptr<char, decltype(&free)> buffer(
+      static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)), &free);
+  return buffer.get();
 }
 
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+bool DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file_size_) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return true;
+  }
+  bool bounce = direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0;
+  char *buf = bounce ? BounceBuffer() : page_data;
+  ssize_t read_count = pread(db_fd_, buf, PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG(ERROR) << "I/O error while reading: " << strerror(errno);
+    read_count = 0;
+  }
+  if (bounce) {
+    memcpy(page_data, buf, read_count);
+  }
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  } else if (crc_fd_ >= 0) {
+    return VerifyChecksum(physical_page_id, page_data);
   }
+  return true;
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+  WritePhysicalPages(physical_page_id, &page_data, 1);
+}
+
+void DiskManager::WritePhysicalPages(page_id_t physical_page_id, const char *const *pages_data, size_t count) {
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
-    return;
+  if (direct_io_) {
+    // O_DIRECT needs every buffer aligned, write page by page through the bounce buffer if needed
+    for (size_t i = 0; i < count; i++) {
+      const char *buf = pages_data[i];
+      if (reinterpret_cast<uintptr_t>(buf) % PAGE_SIZE != 0) {
+        memcpy(BounceBuffer(), buf, PAGE_SIZE);
+        buf = BounceBuffer();
+      }
+      if (pwrite(db_fd_, buf, PAGE_SIZE, offset + i * PAGE_SIZE) != PAGE_SIZE) {
+        LOG(ERROR) << "I/O error while writing: " << strerror(errno);
+        return;
+      }
+    }
+  } else {
+    for (size_t done = 0; done < count;) {
+      struct iovec iov[IOV_MAX];
+      size_t batch = std::min<size_t>(count - done, IOV_MAX);
+      for (size_t i = 0; i < batch; i++) {
+        iov[i].iov_base = const_cast<char *>(pages_data[done + i]);
+        iov[i].iov_len = PAGE_SIZE;
+      }
+      ssize_t written = pwritev(db_fd_, iov, batch, offset + done * PAGE_SIZE);
+      if (written != static_cast<ssize_t>(batch * PAGE_SIZE)) {
+        LOG(ERROR) << "I/O error while writing: " << strerror(errno);
+        return;
+      }
+      done += batch;
+    }
+  }
+  if (crc_fd_ >= 0) {
+    WriteChecksums(physical_page_id, pages_data, count);
+  }
+  // keep the cached file size up to date
+  size_t end = offset + count * PAGE_SIZE;
+  size_t file_size = file_size_;
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
+  }
+}
+
+uint32_t DiskManager::PageChecksum(const char *page_data) {
+  static const auto table = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }();
+  uint32_t crc = 0xFFFFFFFFU;
+  for (size_t i = 0; i < PAGE_SIZE; i++) {
+    crc = (crc >> 8) ^ table[(crc ^ static_cast<uint8_t>(page_data[i])) & 0xFF];
+  }
+  crc = ~crc;
+  return crc == 0 ? 1 : crc;
+}
+
+void DiskManager::WriteChecksums(page_id_t physical_page_id, const char *const *pages_data, size_t count) {
+  std::vector<uint32_t> checksums(count);
+  for (size_t i = 0; i < count; i++) {
+    checksums[i] = PageChecksum(pages_data[i]);
+  }
+  size_t size = count * sizeof(uint32_t);
+  if (pwrite(crc_fd_, checksums.data(), size, static_cast<size_t>(physical_page_id) * sizeof(uint32_t)) !=
+      static_cast<ssize_t>(size)) {
+    LOG(ERROR) << "I/O error while writing checksums: " << strerror(errno);
+  }
+}
+
+bool DiskManager::VerifyChecksum(page_id_t physical_page_id, const char *page_data) {
+  uint32_t expected = 0;
+  if (pread(crc_fd_, &expected, sizeof(expected), static_cast<size_t>(physical_page_id) * sizeof(uint32_t)) !=
+          sizeof(expected) ||
+      expected == 0) {
+    // the page was never written with checksums
+    return true;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+  if (PageChecksum(page_data) != expected) {
+    LOG(ERROR) << "Checksum mismatch on physical page " << physical_page_id << " of " << file_name_
+               << ", the page is torn or corrupted";
+    checksum_failures_++;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,161 @@
+#include "storage/free_space_map.h"
+
+bool FreeSpaceMap::Create() {
+  auto *page = buffer_pool_manager_->NewPage(first_page_id_);
+  if (page == nullptr) {
+    first_page_id_ = INVALID_PAGE_ID;
+    return false;
+  }
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  map_pages_.push_back(first_page_id_);
+  loaded_ = true;
+  return true;
+}
+
+void FreeSpaceMap::Load() {
+  /* 1. 沿链表读入所有的map页 */
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto *page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "Can not fetch free space map page.");
+    auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    map_pages_.push_back(page_id);
+
+    /* 2. 建立内存中的索引 */
+    for (uint32_t i = 0; i < map_page->GetEntryCount(); i++) {
+      uint32_t index = entries_.size();
+      uint32_t free_space = map_page->BucketAt(i) * FreeSpaceMapPage::BUCKET_SIZE;
+      entries_.emplace_back(map_page->PageIdAt(i), free_space);
+      entry_index_[map_page->PageIdAt(i)] = index;
+      buckets_[map_page->BucketAt(i)].insert(index);
+    }
+    page_id_t next_page_id = map_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  loaded_ = true;
+}
+
+void FreeSpaceMap::Destroy() {
+  if (!loaded_) {
+    Load();
+  }
+  for (auto page_id : map_pages_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  map_pages_.clear();
+  entries_.clear();
+  entry_index_.clear();
+  for (auto &bucket : buckets_) {
+    bucket.clear();
+  }
+  first_page_id_ = INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::Clear() {
+  if (!loaded_) {
+    Load();
+  }
+  /* 1. 保留首个map页，其余页释放 */
+  for (size_t i = 1; i < map_pages_.size(); i++) {
+    buffer_pool_manager_->DeletePage(map_pages_[i]);
+  }
+  if (IsPersistent()) {
+    auto *page = buffer_pool_manager_->FetchPage(first_page_id_);
+    ASSERT(page != nullptr, "Can not fetch free space map page.");
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    map_pages_.resize(1);
+  }
+
+  /* 2. 清空内存中的索引 */
+  entries_.clear();
+  entry_index_.clear();
+  for (auto &bucket : buckets_) {
+    bucket.clear();
+  }
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t size, page_id_t hint) const {
+  /* 1. 提示的页按桶向下取整后落在搜索范围之下、确切的空闲空间却放得下时，它是最紧凑的选择 */
+  uint32_t min_bucket = FreeSpaceMapPage::BucketFor(size);
+  auto iter = entry_index_.find(hint);
+  if (iter != entry_index_.end()) {
+    uint32_t free_space = entries_[iter->second].second;
+    if (free_space >= size && FreeSpaceMapPage::BucketOf(free_space) < min_bucket) {
+      return hint;
+    }
+  }
+
+  /* 2. 所在桶一定放得下的页中，取堆中靠前的 */
+  for (uint32_t bucket = min_bucket; bucket < FreeSpaceMapPage::NUM_BUCKETS; bucket++) {
+    if (!buckets_[bucket].empty()) {
+      return entries_[*buckets_[bucket].begin()].first;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  uint32_t bucket = FreeSpaceMapPage::BucketOf(free_space);
+  auto iter = entry_index_.find(page_id);
+
+  /* 1. 新页追加到末尾 */
+  if (iter == entry_index_.end()) {
+    uint32_t index = entries_.size();
+    entries_.emplace_back(page_id, free_space);
+    entry_index_[page_id] = index;
+    buckets_[bucket].insert(index);
+    Persist(index, true);
+    return;
+  }
+
+  /* 2. 已有页更新内存中的空闲空间，只在所属桶变化时写map页，大多数插入不需要写map页 */
+  uint32_t index = iter->second;
+  uint32_t old_free_space = entries_[index].second;
+  if (old_free_space == free_space) {
+    return;
+  }
+  entries_[index].second = free_space;
+  uint32_t old_bucket = FreeSpaceMapPage::BucketOf(old_free_space);
+  if (old_bucket == bucket) {
+    return;
+  }
+  buckets_[old_bucket].erase(index);
+  buckets_[bucket].insert(index);
+  Persist(index, false);
+}
+
+void FreeSpaceMap::Persist(uint32_t index, bool append) {
+  if (!IsPersistent()) {
+    return;
+  }
+  uint32_t map_index = index / FreeSpaceMapPage::MAX_ENTRY_COUNT;
+
+  /* 1. 最后一个map页已满，分配新的map页并接到链表尾部 */
+  if (map_index == map_pages_.size()) {
+    page_id_t new_page_id;
+    auto *new_page = buffer_pool_manager_->NewPage(new_page_id);
+    ASSERT(new_page != nullptr, "Can not allocate free space map page.");
+    reinterpret_cast<FreeSpaceMapPage *>(new_page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+
+    page_id_t last_page_id = map_pages_.back();
+    auto *last_page = buffer_pool_manager_->FetchPage(last_page_id);
+    reinterpret_cast<FreeSpaceMapPage *>(last_page->GetData())->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    map_pages_.push_back(new_page_id);
+  }
+
+  /* 2. 写入表项 */
+  auto *page = buffer_pool_manager_->FetchPage(map_pages_[map_index]);
+  ASSERT(page != nullptr, "Can not fetch free space map page.");
+  auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  if (append) {
+    map_page->Append(entries_[index].first, FreeSpaceMapPage::BucketOf(entries_[index].second));
+  } else {
+    map_page->SetBucketAt(index % FreeSpaceMapPage::MAX_ENTRY_COUNT,
+                          FreeSpaceMapPage::BucketOf(entries_[index].second));
+  }
+  buffer_pool_manager_->UnpinPage(map_pages_[map_index], true);
+}
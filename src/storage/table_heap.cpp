@@ -1,45 +1,174 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+
 /* Transaction 非必须 */
 
 /**
  * TODO: Student Implement
  */
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-  /* 找到table heap中第一个页，unpin该页释放缓存区（recent used） */
-  TablePage *currPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  TablePage *targetPage = nullptr;
-
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
-
-  /* 插入失败，根据first fit原则，去到下一个页
-   * 如果没有通过INVALID_PAGE_ID找到目标页，但同样插入成功，这一情况同样可以接受 */
-  while (!currPage->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
-    page_id_t nextPgId = currPage->GetNextPageId();  // 下个页的页id
-    /* 下一页为无效页，即找到了目标页，分配空间 */
-    if (nextPgId == INVALID_PAGE_ID) {
-      targetPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(nextPgId));
-      // nextPgId作为引用，会自动修改成分配好空间的PageId
-
-      /* 分配空间失败 */
-      if (nextPgId == INVALID_PAGE_ID) return false;
-
-      /* 对新的page做双向链接 */
-      targetPage->Init(nextPgId, currPage->GetPageId(), log_manager_, txn);
-      currPage->SetNextPageId(nextPgId);
-
-      /* 对于新分配空间的页，需要填充数据 */
-      targetPage->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-      buffer_pool_manager_->UnpinPage(targetPage->GetPageId(), true);
-      break;
+  /* 0. 过长的字符串字段放入溢出页，元组中只留引用 */
+  std::vector<page_id_t> overflowPages = GetOverflowFields(row);
+  uint32_t serialized_size = overflowPages.empty() ? row.GetSerializedSize(schema_)
+                                                   : row.GetSerializedSize(schema_, overflowPages);
+  if (serialized_size > TablePage::SIZE_MAX_ROW) return false;
+  std::vector<char> stored;
+  if (!overflowPages.empty() && !StoreOverflowFields(row, &overflowPages, &stored)) return false;
+  uint32_t size = TablePage::GetSpaceNeeded(serialized_size);
+  LoadFreeSpaceMap();
+
+  /* 插入失败时释放已写的溢出页 */
+  auto fail = [&]() {
+    if (!stored.empty()) {
+      for (page_id_t overflowPgId : overflowPages) {
+        if (overflowPgId != INVALID_PAGE_ID) FreeOverflow(overflowPgId);
+      }
     }
-    currPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(nextPgId));
-    buffer_pool_manager_->UnpinPage(currPage->GetPageId(), false);
+    return false;
+  };
+
+  /* 1. 由空闲空间映射直接找到空间足够的页
+   * 映射中的空闲空间向下取整，理论上一定插入成功；若失败说明记录过期，修正后重新查找。
+   * 上次插入的页空闲空间是确切的，按桶取整后找不到但刚好放得下时也选它 */
+  page_id_t currPgId = free_space_map_.FindPage(size, last_insert_page_id_);
+  while (currPgId != INVALID_PAGE_ID) {
+    TablePage *currPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currPgId));
+    if (currPage == nullptr) return fail();
+    bool inserted = InsertIntoPage(currPage, row, stored, txn);
+    UpdateFreeSpace(currPage);
+    buffer_pool_manager_->UnpinPage(currPgId, inserted);
+    if (inserted) {
+      last_insert_page_id_ = currPgId;
+      return true;
+    }
+    currPgId = free_space_map_.FindPage(size, last_insert_page_id_);
+  }
+
+  /* 2. 没有合适的页（大行不会落入任何桶），先尝试尾页 */
+  page_id_t lastPgId = free_space_map_.GetLastPageId();
+  TablePage *lastPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(lastPgId));
+  if (lastPage == nullptr) return fail();
+  if (InsertIntoPage(lastPage, row, stored, txn)) {
+    UpdateFreeSpace(lastPage);
+    buffer_pool_manager_->UnpinPage(lastPgId, true);
+    last_insert_page_id_ = lastPgId;
+    return true;
+  }
+
+  /* 3. 尾页也放不下，在尾部新建页并做双向链接 */
+  page_id_t newPgId;
+  TablePage *newPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(newPgId));
+  if (newPage == nullptr) {
+    buffer_pool_manager_->UnpinPage(lastPgId, false);
+    return fail();
+  }
+  newPage->Init(newPgId, lastPgId, log_manager_, txn);
+  lastPage->SetNextPageId(newPgId);
+  buffer_pool_manager_->UnpinPage(lastPgId, true);
+
+  bool inserted = InsertIntoPage(newPage, row, stored, txn);
+  UpdateFreeSpace(newPage);
+  buffer_pool_manager_->UnpinPage(newPgId, true);
+  if (!inserted) return fail();
+  last_insert_page_id_ = newPgId;
+  return true;
+}
+
+bool TableHeap::InsertTuples(std::vector<Row> &rows, Transaction *txn) {
+  /* 溢出页在插入各行时才写，先只确认每行都放得下 */
+  std::vector<std::vector<page_id_t>> overflowPages(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    overflowPages[i] = GetOverflowFields(rows[i]);
+    uint32_t serialized_size = overflowPages[i].empty() ? rows[i].GetSerializedSize(schema_)
+                                                        : rows[i].GetSerializedSize(schema_, overflowPages[i]);
+    if (serialized_size > TablePage::SIZE_MAX_ROW) return false;
   }
+  LoadFreeSpaceMap();
+
+  /* 当前页一直pin住，直到放不下下一行才换页 */
+  TablePage *currPage = nullptr;
+  page_id_t currPgId = INVALID_PAGE_ID;
+  bool currDirty = false;
+  auto release = [&]() {
+    if (currPage == nullptr) return;
+    if (currDirty) UpdateFreeSpace(currPage);
+    buffer_pool_manager_->UnpinPage(currPgId, currDirty);
+    currPage = nullptr;
+    currDirty = false;
+  };
+
+  /* 中途失败时删除已插入的行（连同其溢出页），并释放当前行已写的溢出页，整批不留下任何一行 */
+  std::vector<char> stored;
+  size_t i = 0;
+  auto rollback = [&]() {
+    release();
+    if (!stored.empty()) {
+      for (page_id_t overflowPgId : overflowPages[i]) {
+        if (overflowPgId != INVALID_PAGE_ID) FreeOverflow(overflowPgId);
+      }
+    }
+    for (size_t j = 0; j < i; j++) {
+      ApplyDelete(rows[j].GetRowId(), txn);
+    }
+    return false;
+  };
+
+  for (; i < rows.size(); i++) {
+    Row &row = rows[i];
+    stored.clear();
+    if (!overflowPages[i].empty() && !StoreOverflowFields(row, &overflowPages[i], &stored)) {
+      return rollback();
+    }
+
+    /* 1. 优先放进当前页 */
+    if (currPage != nullptr && InsertIntoPage(currPage, row, stored, txn)) {
+      currDirty = true;
+      continue;
+    }
+    release();
+    uint32_t size = TablePage::GetSpaceNeeded(stored.empty() ? row.GetSerializedSize(schema_) : stored.size());
+
+    /* 2. 由空闲空间映射找页，记录过期时修正后重新查找 */
+    for (currPgId = free_space_map_.FindPage(size, last_insert_page_id_); currPgId != INVALID_PAGE_ID;
+         currPgId = free_space_map_.FindPage(size, last_insert_page_id_)) {
+      currPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currPgId));
+      if (currPage == nullptr) return rollback();
+      if (InsertIntoPage(currPage, row, stored, txn)) break;
+      UpdateFreeSpace(currPage);
+      buffer_pool_manager_->UnpinPage(currPgId, false);
+      currPage = nullptr;
+    }
+    if (currPage != nullptr) {
+      currDirty = true;
+      continue;
+    }
 
-  /* 插入成功（新增页都是脏页）*/
-  buffer_pool_manager_->UnpinPage(currPage->GetPageId(), true);
+    /* 3. 再尝试尾页 */
+    currPgId = free_space_map_.GetLastPageId();
+    currPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currPgId));
+    if (currPage == nullptr) return rollback();
+    if (InsertIntoPage(currPage, row, stored, txn)) {
+      currDirty = true;
+      continue;
+    }
 
+    /* 4. 在尾部新建页并做双向链接，新页随即记入映射成为新的尾页 */
+    page_id_t newPgId;
+    TablePage *newPage = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(newPgId));
+    if (newPage == nullptr) return rollback();
+    newPage->Init(newPgId, currPgId, log_manager_, txn);
+    currPage->SetNextPageId(newPgId);
+    currDirty = true;
+    release();
+    currPage = newPage;
+    currPgId = newPgId;
+    currDirty = true;
+    if (!InsertIntoPage(currPage, row, stored, txn)) return rollback();
+    UpdateFreeSpace(currPage);
+  }
+  if (currPage != nullptr) last_insert_page_id_ = currPgId;
+  release();
   return true;
 }
 
@@ -62,22 +191,24 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
  * TODO: Student Implement
  */
 bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn) {
+  /* 新旧元组有溢出字段时不原地更新，由调用者删除后重新插入，溢出页随之释放和重写 */
+  if (!GetOverflowFields(row).empty()) return false;
   TablePage *currPg = reinterpret_cast<TablePage *>
       (buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  bool update_indicator;
-
   if(!currPg)  return false; // 未找到页
+  if (MayOverflow() && currPg->IsTupleLive(rid.GetSlotNum()) &&
+      !GetTupleOverflowPages(currPg, rid.GetSlotNum()).empty()) {
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return false;
+  }
 
-  /* 保存当前Page */
-  Row *historyRow = new Row(rid);
-  GetTuple(historyRow, nullptr);
-
-  /* 更新页，由于其未存储至硬盘，标记为脏页 */
-  update_indicator =currPg->UpdateTuple(row, historyRow, schema_, txn,
-                          lock_manager_, log_manager_);
+  /* 页内原地更新，旧元组由页直接反序列化到historyRow，无需再取一次页 */
+  Row historyRow(rid);
+  bool update_indicator = currPg->UpdateTuple(row, &historyRow, schema_, txn,
+                                              lock_manager_, log_manager_);
+  if (update_indicator) UpdateFreeSpace(currPg);
 
-  delete historyRow;
-  buffer_pool_manager_->UnpinPage(currPg->GetPageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), update_indicator);
 
   return update_indicator;
 }
@@ -89,9 +220,16 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Step1: Find the page which contains the tuple.
   TablePage *currPg = reinterpret_cast<TablePage *>
       (buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  if(currPg)  return; // 未找到页
-  // Step2: Delete the tuple from the page.
+  if(!currPg)  return; // 未找到页
+  // Step2: Free the overflow pages of the tuple and delete the tuple from the page.
+  if (MayOverflow() && currPg->HoldsTuple(rid.GetSlotNum())) {
+    for (page_id_t overflowPgId : GetTupleOverflowPages(currPg, rid.GetSlotNum())) {
+      FreeOverflow(overflowPgId);
+    }
+  }
   currPg->ApplyDelete(rid, txn, log_manager_);
+  UpdateFreeSpace(currPg);
+  if (currPg->IsEmpty()) emptied_pages_++;
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
@@ -120,23 +258,86 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   if(!currPg)
     return false;
   else {
-   get_indicator =
-        currPg->GetTuple(row, schema_, txn, lock_manager_);
+    /* 经由行视图读出，溢出字段随之从溢出页读入 */
+    get_indicator = currPg->IsTupleLive(row->GetRowId().GetSlotNum());
+    if (get_indicator) ReadTuple(currPg, row->GetRowId(), row);
     buffer_pool_manager_->UnpinPage(currPgId, false);
     return get_indicator;
   }
 }
 
-void TableHeap::DeleteTable(page_id_t page_id) {
-  if (page_id != INVALID_PAGE_ID) {
-    auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
-    if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
-      DeleteTable(temp_table_page->GetNextPageId());
-    buffer_pool_manager_->UnpinPage(page_id, false);
+void TableHeap::DeleteTable() {
+  /* 由页目录逐页释放，不再沿链表递归；元组引用的溢出页先于所在页释放 */
+  bool mayOverflow = MayOverflow();
+  for (page_id_t page_id : GetPageIds()) {
+    if (mayOverflow) {
+      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      ASSERT(page != nullptr, "Can not fetch table page.");
+      for (uint32_t slot = 0; slot < page->GetTupleCount(); slot++) {
+        if (!page->HoldsTuple(slot)) continue;
+        for (page_id_t overflowPgId : GetTupleOverflowPages(page, slot)) {
+          FreeOverflow(overflowPgId);
+        }
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
     buffer_pool_manager_->DeletePage(page_id);
-  } else {
-    DeleteTable(first_page_id_);
   }
+  free_space_map_.Destroy();
+  first_page_id_ = INVALID_PAGE_ID;
+}
+
+size_t TableHeap::Vacuum(Transaction *txn) {
+  LoadFreeSpaceMap();
+  size_t reclaimed = 0;
+  std::vector<std::pair<page_id_t, uint32_t>> kept_pages;  // <page, free space> of the remaining pages in order
+
+  for (page_id_t currPgId = first_page_id_; currPgId != INVALID_PAGE_ID;) {
+    auto currPg = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currPgId));
+    ASSERT(currPg != nullptr, "Can not fetch table page.");
+    uint32_t compacted = currPg->Compact();
+    page_id_t prevPgId = currPg->GetPrevPageId(), nextPgId = currPg->GetNextPageId();
+
+    /* 1. 非空页（以及首页）只做页内整理 */
+    if (currPgId == first_page_id_ || !currPg->IsEmpty()) {
+      kept_pages.emplace_back(currPgId, currPg->GetFreeSpaceRemaining());
+      buffer_pool_manager_->UnpinPage(currPgId, compacted > 0);
+      reclaimed += compacted;
+      currPgId = nextPgId;
+      continue;
+    }
+
+    /* 2. 空页从双向链表中摘下并释放 */
+    auto prevPg = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prevPgId));
+    ASSERT(prevPg != nullptr, "Can not fetch table page.");
+    prevPg->SetNextPageId(nextPgId);
+    buffer_pool_manager_->UnpinPage(prevPgId, true);
+    if (nextPgId != INVALID_PAGE_ID) {
+      auto nextPg = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(nextPgId));
+      ASSERT(nextPg != nullptr, "Can not fetch table page.");
+      nextPg->SetPrevPageId(prevPgId);
+      buffer_pool_manager_->UnpinPage(nextPgId, true);
+    }
+    buffer_pool_manager_->UnpinPage(currPgId, false);
+    buffer_pool_manager_->DeletePage(currPgId);
+    reclaimed += PAGE_SIZE;
+    currPgId = nextPgId;
+  }
+
+  /* 3. 按剩余页的顺序重建空闲空间映射 */
+  free_space_map_.Clear();
+  for (auto &page : kept_pages) {
+    free_space_map_.Update(page.first, page.second);
+  }
+  emptied_pages_ = 0;
+  return reclaimed;
+}
+
+size_t TableHeap::AutoVacuum(Transaction *txn) {
+  if (emptied_pages_ < static_cast<size_t>(AUTOVACUUM_EMPTY_PAGES)) {
+    return 0;
+  }
+  return Vacuum(txn);
 }
 
 /**
@@ -155,9 +356,14 @@ TableIterator TableHeap::Begin(Transaction *txn) {
     currPg = reinterpret_cast<TablePage *>
         (buffer_pool_manager_->FetchPage(currPgId));
     isFound = currPg->GetFirstTupleRid(&headRID);
+    page_id_t nextPgId = currPg->GetNextPageId();
     buffer_pool_manager_->UnpinPage(currPgId, false);
-    if(isFound) break;
-    currPgId = currPg->GetNextPageId();
+    if(isFound){
+      /* 扫描即将开始，预读后续页面 */
+      PrefetchFrom(nextPgId);
+      break;
+    }
+    currPgId = nextPgId;
   }
 
   if(isFound){
@@ -177,3 +383,183 @@ TableIterator TableHeap::Begin(Transaction *txn) {
 TableIterator TableHeap::End() {
   return TableIterator(Row(), this);
 }
+
+void TableHeap::PrefetchFrom(page_id_t page_id) {
+  if (prefetch_window_ == 0 || page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  /* 1. 后续页号由页目录直接给出，预读线程不必读完一页才知道下一页 */
+  LoadFreeSpaceMap();
+  size_t index = free_space_map_.IndexOf(page_id);
+  if (index == free_space_map_.GetPageCount()) {
+    // 不在目录中的页（不应出现），退回沿链表预读
+    buffer_pool_manager_->PrefetchPages(page_id, prefetch_window_, [](Page *page) {
+      return reinterpret_cast<TablePage *>(page)->GetNextPageId();
+    });
+    return;
+  }
+
+  /* 2. 拷贝出预读窗口内的页号，预读线程不访问目录本身 */
+  std::vector<page_id_t> page_ids;
+  for (size_t i = index; i < free_space_map_.GetPageCount() && page_ids.size() < prefetch_window_; i++) {
+    page_ids.push_back(free_space_map_.GetPageIdAt(i));
+  }
+  size_t next = 1;
+  buffer_pool_manager_->PrefetchPages(page_ids[0], page_ids.size(), [page_ids, next](Page *) mutable {
+    return next < page_ids.size() ? page_ids[next++] : INVALID_PAGE_ID;
+  });
+}
+
+void TableHeap::LoadFreeSpaceMap() {
+  if (free_space_map_.IsLoaded()) {
+    return;
+  }
+  free_space_map_.Load();
+  if (free_space_map_.IsPersistent()) {
+    return;
+  }
+  // no persisted map, e.g. a table created before free space maps existed
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch table page.");
+    UpdateFreeSpace(page);
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::UpdateFreeSpace(TablePage *page) {
+  LoadFreeSpaceMap();
+  free_space_map_.Update(page->GetTablePageId(), page->GetFreeSpaceRemaining());
+}
+
+std::vector<page_id_t> TableHeap::GetOverflowFields(const Row &row) const {
+  std::vector<page_id_t> overflowPages;
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    const Field *field = row.GetField(i);
+    if (field->GetTypeId() != TypeId::kTypeChar || field->IsNull() ||
+        field->GetLength() <= static_cast<uint32_t>(OVERFLOW_FIELD_SIZE)) {
+      continue;
+    }
+    // 占位页号只用来计算大小，写入溢出页时替换
+    overflowPages.resize(row.GetFieldCount(), INVALID_PAGE_ID);
+    overflowPages[i] = 0;
+  }
+  return overflowPages;
+}
+
+bool TableHeap::StoreOverflowFields(const Row &row, std::vector<page_id_t> *overflow_pages,
+                                    std::vector<char> *stored) {
+  /* 1. 逐字段写溢出链，失败时释放已写的链 */
+  for (uint32_t i = 0; i < overflow_pages->size(); i++) {
+    if ((*overflow_pages)[i] == INVALID_PAGE_ID) continue;
+    const Field *field = row.GetField(i);
+    (*overflow_pages)[i] = WriteOverflow(field->GetData(), field->GetLength());
+    if ((*overflow_pages)[i] == INVALID_PAGE_ID) {
+      for (uint32_t j = 0; j < i; j++) {
+        if ((*overflow_pages)[j] != INVALID_PAGE_ID) FreeOverflow((*overflow_pages)[j]);
+      }
+      return false;
+    }
+  }
+
+  /* 2. 序列化引用溢出链的元组 */
+  stored->resize(row.GetSerializedSize(schema_, *overflow_pages));
+  row.SerializeTo(stored->data(), schema_, *overflow_pages);
+  return true;
+}
+
+bool TableHeap::InsertIntoPage(TablePage *page, Row &row, const std::vector<char> &stored, Transaction *txn) {
+  if (stored.empty()) {
+    return page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  }
+  RowId rid;
+  if (!page->InsertTuple(stored.data(), stored.size(), &rid)) {
+    return false;
+  }
+  row.SetRowId(rid);
+  return true;
+}
+
+void TableHeap::ReadTuple(TablePage *page, const RowId &rid, Row *row) {
+  RowView view;
+  view.Reset(page->GetTupleData(rid.GetSlotNum()), schema_, rid, &overflow_reader_);
+  view.ToRow(row);
+}
+
+std::vector<page_id_t> TableHeap::GetTupleOverflowPages(TablePage *page, uint32_t slot_num) {
+  std::vector<page_id_t> overflowPages;
+  RowView view;
+  view.Reset(page->GetTupleData(slot_num), schema_, RowId(page->GetTablePageId(), slot_num));
+  for (uint32_t i = 0; i < view.GetFieldCount(); i++) {
+    if (view.IsOverflow(i)) overflowPages.push_back(view.GetOverflowPageId(i));
+  }
+  return overflowPages;
+}
+
+bool TableHeap::MayOverflow() const {
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    if (schema_->GetColumn(i)->GetType() == TypeId::kTypeChar) return true;
+  }
+  return false;
+}
+
+page_id_t TableHeap::WriteOverflow(const char *data, uint32_t size) {
+  /* 按顺序分配溢出页，每页写满后接到上一页之后；最多同时pin住两页 */
+  page_id_t firstPgId = INVALID_PAGE_ID, prevPgId = INVALID_PAGE_ID;
+  OverflowPage *prevPg = nullptr;
+  uint32_t ofs = 0;
+  do {
+    page_id_t currPgId;
+    Page *page = buffer_pool_manager_->NewPage(currPgId);
+    if (page == nullptr) {
+      if (prevPg != nullptr) buffer_pool_manager_->UnpinPage(prevPgId, true);
+      if (firstPgId != INVALID_PAGE_ID) FreeOverflow(firstPgId);
+      return INVALID_PAGE_ID;
+    }
+    auto currPg = reinterpret_cast<OverflowPage *>(page->GetData());
+    currPg->Init();
+    uint32_t chunk = std::min(size - ofs, OverflowPage::MAX_DATA_SIZE);
+    memcpy(currPg->GetPageData(), data + ofs, chunk);
+    currPg->SetDataSize(chunk);
+    ofs += chunk;
+    if (prevPg != nullptr) {
+      prevPg->SetNextPageId(currPgId);
+      buffer_pool_manager_->UnpinPage(prevPgId, true);
+    } else {
+      firstPgId = currPgId;
+    }
+    prevPg = currPg;
+    prevPgId = currPgId;
+  } while (ofs < size);
+  buffer_pool_manager_->UnpinPage(prevPgId, true);
+  return firstPgId;
+}
+
+void TableHeap::ReadOverflow(page_id_t first_page_id, uint32_t size, char *buf) {
+  uint32_t ofs = 0;
+  for (page_id_t currPgId = first_page_id; currPgId != INVALID_PAGE_ID && ofs < size;) {
+    Page *page = buffer_pool_manager_->FetchPage(currPgId);
+    ASSERT(page != nullptr, "Can not fetch overflow page.");
+    auto currPg = reinterpret_cast<OverflowPage *>(page->GetData());
+    uint32_t chunk = std::min(size - ofs, currPg->GetDataSize());
+    memcpy(buf + ofs, currPg->GetPageData(), chunk);
+    ofs += chunk;
+    page_id_t nextPgId = currPg->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(currPgId, false);
+    currPgId = nextPgId;
+  }
+  ASSERT(ofs == size, "Overflow chain is shorter than its field.");
+}
+
+void TableHeap::FreeOverflow(page_id_t first_page_id) {
+  for (page_id_t currPgId = first_page_id; currPgId != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager_->FetchPage(currPgId);
+    ASSERT(page != nullptr, "Can not fetch overflow page.");
+    page_id_t nextPgId = reinterpret_cast<OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(currPgId, false);
+    buffer_pool_manager_->DeletePage(currPgId);
+    currPgId = nextPgId;
+  }
+}
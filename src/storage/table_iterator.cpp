@@ -1,5 +1,7 @@
 #include "storage/table_iterator.h"
 
+#include <algorithm>
+
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
@@ -13,7 +15,7 @@ TableIterator::TableIterator(Row row, TableHeap *source)
 }
 
 TableIterator::TableIterator(const TableIterator &other)
-: row(other.row), source(other.source) {}
+: row(other.row), source(other.source), pages_until_prefetch(other.pages_until_prefetch) {}
 
 TableIterator::~TableIterator() {
 }
@@ -38,6 +40,7 @@ Row *TableIterator::operator->() {
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
   row = itr.row;
   source = itr.source;
+  pages_until_prefetch = itr.pages_until_prefetch;
   return *this;
 }
 
@@ -48,18 +51,16 @@ TableIterator &TableIterator::operator++() {
   TablePage *currPg = reinterpret_cast<TablePage *>
                         (bpm->FetchPage(currPgId));
   RowId nextRID;
-  Row *tmp = new Row(row.GetRowId());  // 临时变量
   bool isFound = false;
 
   ASSERT(currPg != nullptr, "Fetched null page in TableIt");
 
   /* 能够在当前页找到下一个tuple —— 直接访问并返回 */
+  /* 页已pin住，直接从页中读出tuple，不再经过TableHeap::GetTuple重复取页 */
   if(currPg->GetNextTupleRid(row.GetRowId(), &nextRID)){
-    tmp->SetRowId(nextRID);         // 获取到了rid
-    source->GetTuple(tmp, nullptr); // 获取到了tuple，此时row更新完毕
-    row = *tmp;
+    row = Row(nextRID);             // 获取到了rid
+    source->ReadTuple(currPg, nextRID, &row);
     bpm->UnpinPage(currPgId, false);
-    delete tmp;
     return (*this);
   }
 
@@ -67,9 +68,17 @@ TableIterator &TableIterator::operator++() {
   else {
     while(currPg->GetNextPageId() != INVALID_PAGE_ID) // 下一页非无效页
     {
-      currPgId = currPg->GetPageId();
+      page_id_t nextPgId = currPg->GetNextPageId();
       bpm->UnpinPage(currPgId, false);
-      currPg = reinterpret_cast<TablePage *>(bpm->FetchPage(currPg->GetNextPageId()));
+      currPgId = nextPgId;
+      currPg = reinterpret_cast<TablePage *>(bpm->FetchPage(currPgId));
+      ASSERT(currPg != nullptr, "Fetched null page in TableIt");
+      /* 每跨过窗口一半的页面，预读之后的窗口 */
+      if(pages_until_prefetch == 0) {
+        source->PrefetchFrom(currPg->GetNextPageId());
+        pages_until_prefetch = std::max<size_t>(source->GetPrefetchWindow() / 2, 1);
+      }
+      pages_until_prefetch--;
       // 访问下一页
       if(currPg->GetFirstTupleRid(&nextRID)) {
         isFound = true;
@@ -79,14 +88,12 @@ TableIterator &TableIterator::operator++() {
   }
 
   if(isFound) {
-    tmp->SetRowId(nextRID);         // 获得rid
-    source->GetTuple(tmp, nullptr); // 获得tuple
-    row = *tmp;
+    row = Row(nextRID);             // 获得rid
+    source->ReadTuple(currPg, nextRID, &row);
   }
   else  row = Row();
 
   bpm->UnpinPage(currPgId, false);
-  delete tmp;
 
   return (*this);
 }
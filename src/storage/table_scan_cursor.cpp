@@ -0,0 +1,62 @@
+#include "storage/table_scan_cursor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "storage/table_heap.h"
+
+TableScanCursor::TableScanCursor(TableHeap *table_heap)
+    : table_heap_(table_heap), next_page_id_(table_heap->GetFirstPageId()) {}
+
+TableScanCursor::TableScanCursor(TableHeap *table_heap, std::vector<page_id_t> page_ids)
+    : table_heap_(table_heap),
+      next_page_id_(page_ids.empty() ? INVALID_PAGE_ID : page_ids.front()),
+      follow_chain_(false),
+      page_ids_(std::move(page_ids)),
+      next_page_index_(1) {}
+
+bool TableScanCursor::Next() {
+  RowId rid;
+  while (true) {
+    /* 1. 当前页中还有元组，直接指向页内数据 */
+    if (page_ != nullptr) {
+      bool found = fresh_page_ ? page_->GetFirstTupleRid(&rid) : page_->GetNextTupleRid(view_.GetRowId(), &rid);
+      fresh_page_ = false;
+      if (found) {
+        view_.Reset(page_->GetTupleData(rid.GetSlotNum()), table_heap_->schema_, rid, &table_heap_->overflow_reader_,
+                    projection_);
+        return true;
+      }
+      if (follow_chain_) {
+        next_page_id_ = page_->GetNextPageId();
+      } else {
+        next_page_id_ = next_page_index_ < page_ids_.size() ? page_ids_[next_page_index_++] : INVALID_PAGE_ID;
+      }
+      table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+      page_ = nullptr;
+    }
+
+    /* 2. 当前页已读完，pin住下一页 */
+    if (next_page_id_ == INVALID_PAGE_ID) {
+      return false;
+    }
+    page_ = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id_));
+    ASSERT(page_ != nullptr, "Fetched null page in TableScanCursor");
+    fresh_page_ = true;
+
+    /* 3. 每跨过窗口一半的页面，预读之后的窗口 */
+    if (follow_chain_ && pages_until_prefetch_ == 0) {
+      table_heap_->PrefetchFrom(page_->GetNextPageId());
+      pages_until_prefetch_ = std::max<size_t>(table_heap_->GetPrefetchWindow() / 2, 1);
+    }
+    pages_until_prefetch_--;
+  }
+}
+
+void TableScanCursor::Close() {
+  if (page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+  }
+  next_page_id_ = INVALID_PAGE_ID;
+}
@@ -1,8 +1,12 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -71,4 +75,239 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, ParallelInstancesTest) {
+  const std::string db_name = "bpm_parallel_test.db";
+  const size_t buffer_pool_size = 64;
+  const size_t num_instances = 4;
+  const int num_threads = 4;
+  const int pages_per_thread = 100;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, num_instances);
+  EXPECT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: several sessions create and fill their own pages concurrently.
+  std::vector<std::vector<page_id_t>> page_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(page_id);
+        while (page == nullptr) {
+          std::this_thread::yield();
+          page = bpm->NewPage(page_id);
+        }
+        snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+        page_ids[t].push_back(page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  // Scenario: concurrent readers see what was written, even after the pages have been evicted.
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      char expected[PAGE_SIZE];
+      for (int round = 0; round < 3; round++) {
+        for (auto page_id : page_ids[(t + round) % num_threads]) {
+          Page *page = bpm->FetchPage(page_id);
+          while (page == nullptr) {
+            std::this_thread::yield();
+            page = bpm->FetchPage(page_id);
+          }
+          snprintf(expected, PAGE_SIZE, "page %d", page_id);
+          EXPECT_STREQ(expected, page->GetData());
+          EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, FlushTest) {
+  const std::string db_name = "bpm_flush_test.db";
+  const size_t buffer_pool_size = 20;
+  const int num_pages = 10;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  bpm->SetDirtyRatioTarget(1);
+
+  // Scenario: dirty some pages while the background writer is off, the first one stays pinned.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "checkpoint %d", page_id);
+    page_ids.push_back(page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+
+  // Scenario: a checkpoint writes every dirty page, pinned or not, exactly once.
+  EXPECT_EQ(num_pages, bpm->FlushAllPages());
+  EXPECT_EQ(0, bpm->FlushAllPages());
+  char expected[PAGE_SIZE];
+  char data[PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    disk_manager->ReadPage(page_id, data);
+    snprintf(expected, PAGE_SIZE, "checkpoint %d", page_id);
+    EXPECT_STREQ(expected, data);
+  }
+
+  // Scenario: the checkpoint wrote the allocation of its pages as well, a crash now would not free them.
+  auto *reopened = new DiskManager(db_name);
+  for (auto page_id : page_ids) {
+    EXPECT_FALSE(reopened->IsPageFree(page_id));
+  }
+  delete reopened;
+
+  // Scenario: with a target of 0 the background writer cleans unpinned pages but leaves pinned ones alone.
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "background %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->SetDirtyRatioTarget(0);
+  for (size_t i = 1; i < page_ids.size(); i++) {
+    snprintf(expected, PAGE_SIZE, "background %d", page_ids[i]);
+    for (int retry = 0; retry < 100; retry++) {
+      disk_manager->ReadPage(page_ids[i], data);
+      if (strcmp(expected, data) == 0) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_STREQ(expected, data);
+  }
+  EXPECT_EQ(1, bpm->FlushAllPages());
+  bpm->UnpinPage(page_ids[0], false);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, FlushWhileModifiedTest) {
+  const std::string db_name = "bpm_flush_modified_test.db";
+  remove(db_name.c_str());
+  remove((db_name + ".crc").c_str());
+  auto *disk_manager = new DiskManager(db_name, false, false, true);
+  auto *bpm = new BufferPoolManager(8, disk_manager, 1);
+  bpm->SetDirtyRatioTarget(1);
+
+  // Scenario: a page is rewritten without a latch while checkpoints write it back. Every image written is a copy
+  // taken at one moment, so it always matches its checksum.
+  page_id_t page_id;
+  Page *page = bpm->NewPage(page_id);
+  ASSERT_NE(nullptr, page);
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    for (char value = 0; !stop; value++) {
+      memset(page->GetData(), value, PAGE_SIZE);
+    }
+  });
+  char data[PAGE_SIZE];
+  for (int i = 0; i < 200; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, true);
+    EXPECT_EQ(1, bpm->FlushAllPages());
+    disk_manager->ReadPage(page_id, data);
+  }
+  stop = true;
+  writer.join();
+  EXPECT_EQ(0, disk_manager->GetChecksumFailures());
+  bpm->UnpinPage(page_id, false);
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove((db_name + ".crc").c_str());
+}
+
+TEST(BufferPoolManagerTest, ReadOnlyTest) {
+  const std::string db_name = "bpm_read_only_test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 20;
+
+  remove(db_name.c_str());
+  std::vector<page_id_t> page_ids;
+  {
+    DiskManager disk_manager(db_name);
+    BufferPoolManager bpm(buffer_pool_size, &disk_manager, 2);
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "read only %d", page_id);
+      page_ids.push_back(page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+  }
+
+  // Scenario: pages are served from the mapping, even when the pool is smaller than the database.
+  auto *disk_manager = new DiskManager(db_name, false, true);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  ASSERT_TRUE(disk_manager->IsReadOnly());
+  char expected[PAGE_SIZE];
+  for (int round = 0; round < 2; round++) {
+    for (auto page_id : page_ids) {
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(disk_manager->GetPageView(page_id), page->GetData());
+      snprintf(expected, PAGE_SIZE, "read only %d", page_id);
+      EXPECT_STREQ(expected, page->GetData());
+      bpm->UnpinPage(page_id, false);
+    }
+  }
+
+  // Scenario: nothing can be allocated, deleted or written back.
+  page_id_t new_page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(new_page_id));
+  EXPECT_FALSE(bpm->DeletePage(page_ids[0]));
+  Page *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "modified");
+  bpm->UnpinPage(page_ids[0], true);
+  EXPECT_FALSE(bpm->FlushPage(page_ids[0]));
+  EXPECT_EQ(0, bpm->FlushAllPages());
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+
+  // Scenario: in-memory modifications never reach the file.
+  disk_manager = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(page_ids[0], data);
+  snprintf(expected, PAGE_SIZE, "read only %d", page_ids[0]);
+  EXPECT_STREQ(expected, data);
+  EXPECT_FALSE(disk_manager->IsPageFree(page_ids.back()));
+  disk_manager->Close();
+  remove(db_name.c_str());
+  delete disk_manager;
+}
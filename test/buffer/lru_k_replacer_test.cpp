@@ -0,0 +1,60 @@
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frames 1-4 are accessed twice, then 5 and 6 are touched once by a scan.
+  for (int round = 0; round < 2; round++) {
+    for (int i = 1; i <= 4; i++) {
+      lru_k_replacer.Unpin(i);
+      lru_k_replacer.Pin(i);
+    }
+  }
+  for (int i = 1; i <= 4; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Unpin(6);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: scanned frames have an infinite k-distance and are evicted first, oldest first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+
+  // Scenario: then the frame whose second most recent access is the oldest.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: pinned frames are not victimized, and a re-access moves a frame back.
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+
+  // Scenario: a victimized frame starts over with an empty history.
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(3);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: a removed frame starts over with an empty history as well.
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+  lru_k_replacer.Unpin(2);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+}
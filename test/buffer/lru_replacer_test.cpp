@@ -39,4 +39,36 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(6, value);
   lru_replacer.Victim(&value);
   EXPECT_EQ(4, value);
-}
\ No newline at end of file
+}
+
+TEST(LRUReplacerTest, FullCapacityTest) {
+  const int num_pages = 1000;
+  LRUReplacer lru_replacer(num_pages);
+
+  // Scenario: every frame, including the last one, can be tracked.
+  for (int i = num_pages - 1; i >= 0; i--) {
+    lru_replacer.Unpin(i);
+  }
+  EXPECT_EQ(num_pages, lru_replacer.Size());
+
+  // Scenario: pin the even frames and re-unpin them, they become the most recently used.
+  for (int i = 0; i < num_pages; i += 2) {
+    lru_replacer.Pin(i);
+  }
+  EXPECT_EQ(num_pages / 2, lru_replacer.Size());
+  for (int i = 0; i < num_pages; i += 2) {
+    lru_replacer.Unpin(i);
+  }
+
+  int value;
+  for (int i = num_pages - 1; i >= 0; i -= 2) {
+    ASSERT_TRUE(lru_replacer.Victim(&value));
+    EXPECT_EQ(i, value);
+  }
+  for (int i = 0; i < num_pages; i += 2) {
+    ASSERT_TRUE(lru_replacer.Victim(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_replacer.Size());
+}
@@ -0,0 +1,100 @@
+#include "buffer/page_table.h"
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(16);
+  frame_id_t frame_id;
+
+  // Scenario: page ids of one buffer pool instance share a residue, they must still be found.
+  for (int i = 0; i < 16; i++) {
+    page_table.Insert(i * 8 + 3, i);
+  }
+  EXPECT_EQ(16, page_table.Size());
+  for (int i = 0; i < 16; i++) {
+    ASSERT_TRUE(page_table.Find(i * 8 + 3, &frame_id));
+    EXPECT_EQ(i, frame_id);
+  }
+  EXPECT_FALSE(page_table.Find(4, &frame_id));
+
+  // Scenario: inserting an existing page id overwrites its frame.
+  page_table.Insert(11, 15);
+  ASSERT_TRUE(page_table.Find(11, &frame_id));
+  EXPECT_EQ(15, frame_id);
+  EXPECT_EQ(16, page_table.Size());
+
+  // Scenario: erase every other entry, the rest must stay reachable.
+  for (int i = 0; i < 16; i += 2) {
+    EXPECT_TRUE(page_table.Erase(i * 8 + 3));
+  }
+  EXPECT_FALSE(page_table.Erase(3));
+  EXPECT_EQ(8, page_table.Size());
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(i % 2 == 1, page_table.Find(i * 8 + 3, &frame_id));
+  }
+}
+
+TEST(PageTableTest, ChurnTest) {
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  frame_id_t frame_id;
+
+  // Scenario: evict-and-reload churn keeps the table consistent with a reference map.
+  for (int i = 0; i < 100000; i++) {
+    page_id_t page_id = (i * 7919) % 1000;
+    if (expected.count(page_id) != 0) {
+      EXPECT_TRUE(page_table.Erase(page_id));
+      expected.erase(page_id);
+    } else if (expected.size() < num_frames) {
+      page_table.Insert(page_id, i % num_frames);
+      expected[page_id] = i % num_frames;
+    }
+  }
+  EXPECT_EQ(expected.size(), page_table.Size());
+  for (page_id_t page_id = 0; page_id < 1000; page_id++) {
+    bool found = page_table.Find(page_id, &frame_id);
+    ASSERT_EQ(expected.count(page_id) != 0, found);
+    if (found) {
+      EXPECT_EQ(expected[page_id], frame_id);
+    }
+  }
+}
+
+TEST(PageTableTest, ConcurrentReadTest) {
+  PageTable page_table(32);
+  for (int i = 0; i < 16; i++) {
+    page_table.Insert(i, i);
+  }
+
+  // Scenario: readers never see a wrong frame for the stable entries while a writer churns other entries.
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&page_table]() {
+      frame_id_t frame_id;
+      for (int round = 0; round < 20000; round++) {
+        page_id_t page_id = round % 16;
+        if (page_table.Find(page_id, &frame_id)) {
+          EXPECT_EQ(page_id, frame_id);
+        }
+      }
+    });
+  }
+  for (int round = 0; round < 20000; round++) {
+    page_id_t page_id = 100 + round % 16;
+    page_table.Insert(page_id, 16 + round % 16);
+    page_table.Erase(page_id);
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  frame_id_t frame_id;
+  for (int i = 0; i < 16; i++) {
+    ASSERT_TRUE(page_table.Find(i, &frame_id));
+    EXPECT_EQ(i, frame_id);
+  }
+}
@@ -125,4 +125,42 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogIndexKeySizeTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("s", TypeId::kTypeChar, 246, 0, false, true),
+                                   new Column("t", TypeId::kTypeChar, 493, 1, false, false),
+                                   new Column("v", TypeId::kTypeChar, 494, 2, false, false),
+                                   new Column("w", TypeId::kTypeChar, 501, 3, false, true),
+                                   new Column("x", TypeId::kTypeChar, 502, 4, false, true)};
+  TableInfo *table_info = nullptr;
+  Transaction txn;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", new Schema(columns), &txn, table_info));
+
+  /* 1. 编码后不超过504字节的键用512字节的键建索引，更长的键建不成，且不留下索引 */
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-t", {"t"}, &txn, index_info, "bptree"));
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-v", {"v"}, &txn, index_info, "bptree"));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-v", index_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-w", {"w"}, &txn, index_info, "bptree"));
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-x", {"x"}, &txn, index_info, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-s", {"s"}, &txn, index_info, "bptree"));
+
+  /* 2. 每页只放得下几个键，插入足够多的键使树分裂，再逐个查回 */
+  std::vector<std::string> values;
+  for (int i = 0; i < 100; i++) {
+    values.push_back(std::string(200, 'a' + i % 26) + std::to_string(i));
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(values.back().c_str()), values.back().size(),
+                                    true)};
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(Row(fields), RowId(1000, i), nullptr));
+  }
+  for (int i = 0; i < 100; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(values[i].c_str()), values[i].size(), true)};
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(fields), ret, &txn));
+    ASSERT_EQ(1, ret.size());
+    ASSERT_EQ(RowId(1000, i).Get(), ret[0].Get());
+  }
+  delete db_01;
+}
@@ -1,12 +1,15 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include <algorithm>
+
 #include "executor/plans/delete_plan.h"
 #include "executor/plans/insert_plan.h"
 #include "executor/plans/seq_scan_plan.h"
 #include "executor/plans/index_scan_plan.h"
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
+#include "planner/expressions/logic_expression.h"
 #include "executor_test_util.h"  // NOLINT
 
 // SELECT id FROM table-1 WHERE id < 500
@@ -32,6 +35,41 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   }
 }
 
+// SELECT name, id FROM table-1 WHERE account > 0
+TEST_F(ExecutorTest, SeqScanProjectionTest) {
+  // Construct query plan
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  Schema *schema = table_info->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_name = MakeColumnValueExpression(*schema, 0, "name");
+  auto col_account = MakeColumnValueExpression(*schema, 0, "account");
+  auto const0 = MakeConstantValueExpression(Field(kTypeFloat, 0.f));
+  auto predicate = MakeComparisonExpression(col_account, const0, ">");
+  auto out_schema = MakeOutputSchema({{"name", col_name}, {"id", col_id}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+  ASSERT_EQ(std::vector<uint32_t>({1, 0}), plan->GetOutputColumns());
+  ASSERT_EQ(std::vector<uint32_t>({0, 1, 2}), plan->GetReferencedColumns());
+
+  // Execute
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+
+  // Verify against the rows of the table in scan order
+  std::vector<Row> expected;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); iter++) {
+    if (iter->GetField(2)->CompareGreaterThan(Field(kTypeFloat, 0.f)) == CmpBool::kTrue) {
+      expected.push_back(*iter);
+    }
+  }
+  ASSERT_EQ(expected.size(), result_set.size());
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(2, result_set[i].GetFieldCount());
+    ASSERT_EQ(CmpBool::kTrue, result_set[i].GetField(0)->CompareEquals(*expected[i].GetField(1)));
+    ASSERT_EQ(CmpBool::kTrue, result_set[i].GetField(1)->CompareEquals(*expected[i].GetField(0)));
+  }
+}
+
 // DELETE FROM table-1 WHERE id == 50;
 TEST_F(ExecutorTest, SimpleDeleteTest) {
   // Construct query plan
@@ -61,7 +99,7 @@ TEST_F(ExecutorTest, SimpleDeleteTest) {
     Row row;
     row = start.operator*();
     row.GetKeyFromRow(tableInfo->GetSchema(), index_info->GetIndexKeySchema(), row);
-    index_info->GetIndex()->InsertEntry(row, RowId(), nullptr);
+    index_info->GetIndex()->InsertEntry(row, start.operator*().GetRowId(), nullptr);
   }
 
   std::vector<Row> result_set;
@@ -229,4 +267,59 @@ TEST_F(ExecutorTest, SimpleIndexTest) {
   for (const auto &row : result_set) {
     ASSERT_TRUE(row.GetField(0)->CompareEquals(Field(kTypeInt, 50)));
   }
-}
\ No newline at end of file
+}
+
+// SELECT a FROM table-2 WHERE a = 5 AND u > 900; SELECT a FROM table-2 WHERE g = 3 AND a < 40;
+TEST_F(ExecutorTest, MultiIndexScanTest) {
+  /* 0. 建表table-2(a, u unique, g)，行i为(i, 1000 - i, i % 7)，三列各建索引，g上的索引不唯一 */
+  auto catalog = GetExecutorContext()->GetCatalog();
+  std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, false, true),
+                                   new Column("u", TypeId::kTypeInt, 1, false, true),
+                                   new Column("g", TypeId::kTypeInt, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_info));
+  for (int i = 0; i < 100; i++) {
+    Row row(Fields{Field(kTypeInt, i), Field(kTypeInt, 1000 - i), Field(kTypeInt, i % 7)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  std::vector<IndexInfo *> indexes;
+  for (const std::string column : {"a", "u", "g"}) {
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-2", "index-" + column, {column}, GetTxn(), index_info, "bptree"));
+    for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); iter++) {
+      Row key;
+      iter->GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key);
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, iter->GetRowId(), nullptr));
+    }
+    indexes.push_back(index_info);
+  }
+
+  /* 1. 每个比较都应扫描其列所在的索引，两个索引各自的结果求交集 */
+  Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "a");
+  auto col_u = MakeColumnValueExpression(*schema, 0, "u");
+  auto col_g = MakeColumnValueExpression(*schema, 0, "g");
+  auto out_schema = MakeOutputSchema({{"a", col_a}});
+  auto scan = [&](const AbstractExpressionRef &predicate, const std::vector<IndexInfo *> &scanned) {
+    auto plan = std::make_shared<IndexScanPlanNode>(out_schema, "table-2", scanned, true, predicate);
+    std::vector<Row> result_set;
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> values;
+    for (auto &row : result_set) {
+      values.push_back(std::stoi(row.GetField(0)->toString()));
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+  auto a_eq_5 = MakeComparisonExpression(col_a, MakeConstantValueExpression(Field(kTypeInt, 5)), "=");
+  auto u_gt_900 = MakeComparisonExpression(col_u, MakeConstantValueExpression(Field(kTypeInt, 900)), ">");
+  auto unique_predicate = std::make_shared<LogicExpression>(a_eq_5, u_gt_900, LogicType::And);
+  EXPECT_EQ(std::vector<int32_t>({5}), scan(unique_predicate, {indexes[0], indexes[1]}));
+  EXPECT_EQ(std::vector<int32_t>({5}), scan(unique_predicate, {indexes[1], indexes[0]}));
+
+  auto g_eq_3 = MakeComparisonExpression(col_g, MakeConstantValueExpression(Field(kTypeInt, 3)), "=");
+  auto a_lt_40 = MakeComparisonExpression(col_a, MakeConstantValueExpression(Field(kTypeInt, 40)), "<");
+  auto duplicate_predicate = std::make_shared<LogicExpression>(g_eq_3, a_lt_40, LogicType::And);
+  EXPECT_EQ(std::vector<int32_t>({3, 10, 17, 24, 31, 38}), scan(duplicate_predicate, {indexes[0], indexes[2]}));
+  EXPECT_EQ(std::vector<int32_t>({3, 10, 17, 24, 31, 38}), scan(duplicate_predicate, {indexes[2], indexes[0]}));
+}
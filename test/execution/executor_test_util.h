@@ -5,6 +5,9 @@
 #ifndef MINISQL_EXECUTOR_TEST_UTIL_H
 #define MINISQL_EXECUTOR_TEST_UTIL_H
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -36,6 +39,12 @@ class ExecutorTest : public ::testing::Test {
   void SetUp() override {
     ::testing::Test::SetUp();
 
+    // The execution engine opens every database under ./databases, run in a directory of our own so that the files
+    // left by other tests are not taken for databases, and construct it before the test database exists
+    mkdir("executor_test_root", 0777);
+    ASSERT_EQ(0, chdir("executor_test_root"));
+    execution_engine_ = std::make_unique<ExecuteEngine>();
+
     // Initialize the database subsystems
     db_test_ = new DBStorageEngine("executor_test.db", true);
     auto &catalog_01 = db_test_->catalog_mgr_;
@@ -59,13 +68,15 @@ class ExecutorTest : public ::testing::Test {
     }
     // Create an executor context for our executors
     exec_ctx_ = std::make_unique<ExecuteContext>(txn_, db_test_->catalog_mgr_, db_test_->bpm_);
-
-    // Construct the executor engine for the test
-    execution_engine_ = std::make_unique<ExecuteEngine>();
   }
 
   /** Called after every executor test. */
-  void TearDown() override { delete db_test_; };
+  void TearDown() override {
+    execution_engine_.reset();
+    delete db_test_;
+    remove("./databases/executor_test.db");
+    ASSERT_EQ(0, chdir(".."));
+  };
 
   /** @return The executor context for our test instance. */
   ExecuteContext *GetExecutorContext() { return exec_ctx_.get(); }
@@ -28,6 +28,94 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   ASSERT_EQ(0, KP.CompareKeys(k1, k2));
 }
 
+TEST(BPlusTreeTests, BPlusTreeIndexKeyOrderTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 8, 2, true, false)};
+  auto *key_schema = new Schema(columns);
+  KeyManager KP(key_schema, 32);
+  char empty[] = "", ab[] = "ab", ab0[] = "ab\0", abc[] = "abc", b[] = "b";
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeInt), Field(TypeId::kTypeFloat, 1.0f), Field(TypeId::kTypeChar, b, 1, false)},
+      {Field(TypeId::kTypeInt, -65537), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, ab, 2, false)},
+      {Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, ab, 2, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, -2.5f), Field(TypeId::kTypeChar, ab, 2, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, -0.0f), Field(TypeId::kTypeChar)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, empty, 0, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, ab, 2, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, ab0, 3, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.0f), Field(TypeId::kTypeChar, abc, 3, false)},
+      {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 1e-30f), Field(TypeId::kTypeChar, b, 1, false)},
+      {Field(TypeId::kTypeInt, 7), Field(TypeId::kTypeFloat), Field(TypeId::kTypeChar, b, 1, false)},
+      {Field(TypeId::kTypeInt, 7), Field(TypeId::kTypeFloat, -1e30f), Field(TypeId::kTypeChar, b, 1, false)},
+      {Field(TypeId::kTypeInt, 2147483647), Field(TypeId::kTypeFloat, 3.5f), Field(TypeId::kTypeChar, b, 1, false)}};
+
+  /* 1. 编码后的键按memcmp排序与逐字段比较一致，-0.0与0.0相等 */
+  std::vector<GenericKey *> keys;
+  for (auto &fields : rows) {
+    keys.push_back(KP.InitKey());
+    KP.SerializeFromKey(keys.back(), Row(fields), key_schema);
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      int expected = Row(rows[i]).CompareTo(Row(rows[j]));
+      ASSERT_EQ((expected > 0) - (expected < 0), KP.CompareKeys(keys[i], keys[j])) << i << " " << j;
+    }
+  }
+
+  /* 2. 键可以解码回原来的字段 */
+  for (size_t i = 0; i < keys.size(); i++) {
+    Row key;
+    KP.DeserializeToKey(keys[i], key, key_schema);
+    ASSERT_EQ(0, key.CompareTo(Row(rows[i])));
+    free(keys[i]);
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexFixedKeyTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 2, true, false)};
+  const TableSchema table_schema(columns);
+  int ints[] = {-2147483647 - 1, -65537, -1, 0, 1, 255, 256, 65536, 2147483647};
+  float floats[] = {-1e30f, -2.5f, -0.0f, 0.0f, 1e-30f, 1.0f, 3.5f};
+
+  /* 1. 单列int、int+float和含字符串的键分别选用一个字、两个字和memcmp比较器，结果都与CompareKeys一致 */
+  std::vector<std::vector<uint32_t>> key_maps = {{0}, {0, 1}, {0, 2}};
+  for (auto &key_map : key_maps) {
+    auto *key_schema = Schema::ShallowCopySchema(&table_schema, key_map);
+    KeyManager KP(key_schema, 32);
+    std::vector<GenericKey *> keys;
+    for (int i : ints) {
+      for (float f : floats) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, f),
+                                  Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, false)};
+        std::vector<Field> key_fields;
+        for (auto idx : key_map) {
+          key_fields.emplace_back(fields[idx]);
+        }
+        keys.push_back(KP.InitKey());
+        KP.SerializeFromKey(keys.back(), Row(key_fields), key_schema);
+      }
+      keys.push_back(KP.InitKey());
+      std::vector<Field> null_fields;
+      for (auto idx : key_map) {
+        null_fields.emplace_back(table_schema.GetColumn(idx)->GetType());
+      }
+      KP.SerializeFromKey(keys.back(), Row(null_fields), key_schema);
+    }
+    for (auto lhs : keys) {
+      for (auto rhs : keys) {
+        ASSERT_EQ(KP.CompareKeys(lhs, rhs), KP.WithComparator([&](const auto &cmp) { return cmp(lhs, rhs); }));
+      }
+    }
+    for (auto key : keys) {
+      free(key);
+    }
+  }
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   //  using INDEX_KEY_TYPE = GenericKey<32>;
   //  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
@@ -66,4 +154,52 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     i++;
   }
   delete index;
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexDuplicateKeyTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("grade", TypeId::kTypeInt, 1, false, false)};
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, index_schema, 32, engine.bpm_, false);
+  ASSERT_FALSE(index->IsUnique());
+
+  /* 1. 每个键插入多行，同键的项跨越多个叶节点 */
+  const int grades = 5, rows_per_grade = 400;
+  for (int i = 0; i < grades * rows_per_grade; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i % grades)};
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(i / 64, i % 64), nullptr));
+  }
+
+  /* 2. 等值查找返回该键的每一行，范围查找不重不漏 */
+  auto scan = [&](int grade, const std::string &op) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, grade)};
+    std::vector<RowId> result;
+    index->ScanKey(Row(fields), result, nullptr, op);
+    return result;
+  };
+  for (int grade = 0; grade < grades; grade++) {
+    auto result = scan(grade, "=");
+    ASSERT_EQ(rows_per_grade, result.size());
+    for (auto rid : result) {
+      ASSERT_EQ(grade, (rid.GetPageId() * 64 + rid.GetSlotNum()) % grades);
+    }
+    ASSERT_EQ(rows_per_grade * (grades - grade - 1), scan(grade, ">").size());
+    ASSERT_EQ(rows_per_grade * (grades - grade), scan(grade, ">=").size());
+    ASSERT_EQ(rows_per_grade * grade, scan(grade, "<").size());
+    ASSERT_EQ(rows_per_grade * (grade + 1), scan(grade, "<=").size());
+  }
+  ASSERT_TRUE(scan(grades, "=").empty());
+
+  /* 3. 删除只移除RowId对应的那一项 */
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 2)};
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(Row(fields), RowId(0, 2), nullptr));
+  auto result = scan(2, "=");
+  ASSERT_EQ(rows_per_grade - 1, result.size());
+  for (auto rid : result) {
+    ASSERT_FALSE(rid == RowId(0, 2));
+  }
+  ASSERT_EQ(rows_per_grade, scan(1, "=").size());
+  delete index;
+}
@@ -0,0 +1,99 @@
+#include "index/key_search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+
+/* 旧的二分查找，作为正确性与性能的参照 */
+template <typename Comparator>
+static int BinarySearch(const char *keys, int stride, int n, const GenericKey *key, const Comparator &comparator) {
+  int L = 0, R = n - 1, M;
+  while (L <= R) {
+    M = (L + R) / 2;
+    int direction = comparator(key, reinterpret_cast<const GenericKey *>(keys + M * stride));
+    if (direction == -1)
+      R = M - 1;
+    else if (direction == 1)
+      L = M + 1;
+    else
+      return M;
+  }
+  return L;
+}
+
+TEST(KeySearchTest, KernelTest) {
+  /* 0. 按叶结点的布局排好键：16字节的键后跟8字节的RowId */
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto *key_schema = new Schema(columns);
+  KeyManager KP(key_schema, 16);
+  const int stride = KP.GetKeySize() + sizeof(RowId);
+  const int n = 160;
+  std::vector<char> page(n * stride, 0);
+  std::vector<GenericKey *> probes;
+  for (int i = -1; i <= 2 * n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i * 3 - n)};
+    probes.push_back(KP.InitKey());
+    KP.SerializeFromKey(probes.back(), Row(fields), key_schema);
+    if (i >= 0 && i % 2 == 0 && i / 2 < n) {
+      memcpy(page.data() + i / 2 * stride, probes.back(), KP.GetKeySize());
+    }
+  }
+
+  /* 1. 各内核、各比较器的上下界都与逐个比较的结果一致 */
+  std::vector<KeySearch::CountLessFunc> kernels = {KeySearch::CountLessScalar};
+  if (__builtin_cpu_supports("sse4.2")) kernels.push_back(KeySearch::CountLessSse42);
+  if (__builtin_cpu_supports("avx2")) kernels.push_back(KeySearch::CountLessAvx2);
+  for (int size = 0; size <= n; size += 7) {
+    for (auto probe : probes) {
+      int lower = 0, upper = 0;
+      for (int i = 0; i < size; i++) {
+        int cmp = KP.CompareKeys(reinterpret_cast<const GenericKey *>(page.data() + i * stride), probe);
+        lower += cmp < 0;
+        upper += cmp <= 0;
+      }
+      for (auto kernel : kernels) {
+        ASSERT_EQ(lower, kernel(page.data(), stride, size, WordKeyComparator::Load(reinterpret_cast<char *>(probe))));
+      }
+      ASSERT_EQ(lower, KeySearch::LowerBound(page.data(), stride, size, probe, WordKeyComparator()));
+      ASSERT_EQ(upper, KeySearch::UpperBound(page.data(), stride, size, probe, WordKeyComparator()));
+      ASSERT_EQ(lower, KeySearch::LowerBound(page.data(), stride, size, probe, MemcmpKeyComparator(5)));
+      ASSERT_EQ(upper, KeySearch::UpperBound(page.data(), stride, size, probe, MemcmpKeyComparator(5)));
+      ASSERT_EQ(lower, BinarySearch(page.data(), stride, size, probe, WordKeyComparator()));
+    }
+  }
+
+  /* 2. 与旧的二分查找对比耗时，只输出不作断言 */
+  std::mt19937 rng(2023);
+  std::vector<GenericKey *> lookups(1 << 16);
+  for (auto &lookup : lookups) {
+    lookup = probes[rng() % probes.size()];
+  }
+  auto time = [&](auto &&search) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t sum = 0;
+    for (auto lookup : lookups) {
+      sum += search(lookup);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GT(sum, 0);
+    return static_cast<double>(ns) / lookups.size();
+  };
+  double binary = time([&](GenericKey *key) {
+    return BinarySearch(page.data(), stride, n, key, WordKeyComparator());
+  });
+  double kernel = time([&](GenericKey *key) {
+    return KeySearch::LowerBound(page.data(), stride, n, key, WordKeyComparator());
+  });
+  std::cout << "binary search: " << binary << " ns/lookup, " << KeySearch::GetKernelName() << ": " << kernel
+            << " ns/lookup" << std::endl;
+
+  for (auto probe : probes) {
+    free(probe);
+  }
+  delete key_schema;
+}
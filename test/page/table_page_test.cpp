@@ -0,0 +1,66 @@
+#include "page/table_page.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(PageTests, FormerTablePageTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  auto make_row = [](int i) {
+    std::string name(i % 10 + 1, 'a' + i % 26);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    return Row(fields);
+  };
+
+  /* 0. 写入几行后把页面改写成旧格式：槽数组紧跟24字节的页头，4字节的TupleCount */
+  Page page;
+  auto *table_page = reinterpret_cast<TablePage *>(&page);
+  table_page->Init(7, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page->HasLiveSlots());
+  for (int i = 0; i < 6; i++) {
+    Row row = make_row(i);
+    ASSERT_TRUE(table_page->InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+  }
+  uint32_t free_space = table_page->GetFreeSpaceRemaining();
+  uint32_t tuple_count = table_page->GetTupleCount();
+  memmove(page.GetData() + 24, page.GetData() + 88, 8 * tuple_count);
+  memcpy(page.GetData() + 20, &tuple_count, sizeof(uint32_t));
+  ASSERT_FALSE(table_page->HasLiveSlots());
+  ASSERT_EQ(free_space + 64, table_page->GetFreeSpaceRemaining());
+
+  /* 1. 旧格式的页照常读出、跳过已删除的行 */
+  ASSERT_TRUE(table_page->MarkDelete(RowId(7, 1), nullptr, nullptr, nullptr));
+  table_page->ApplyDelete(RowId(7, 1), nullptr, nullptr);
+  ASSERT_TRUE(table_page->MarkDelete(RowId(7, 4), nullptr, nullptr, nullptr));
+  std::vector<uint32_t> slots;
+  RowId rid;
+  for (bool found = table_page->GetFirstTupleRid(&rid); found; found = table_page->GetNextTupleRid(rid, &rid)) {
+    slots.push_back(rid.GetSlotNum());
+    Row row(rid);
+    ASSERT_TRUE(table_page->GetTuple(&row, &schema, nullptr, nullptr));
+    Field id(TypeId::kTypeInt, static_cast<int32_t>(rid.GetSlotNum()));
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(id));
+  }
+  EXPECT_EQ(std::vector<uint32_t>({0, 2, 3, 5}), slots);
+  EXPECT_EQ(4, table_page->GetLiveTupleCount());
+  EXPECT_FALSE(table_page->IsTupleLive(4));
+
+  /* 2. 插入、回滚删除与整理仍按旧格式进行 */
+  Row row = make_row(1);
+  ASSERT_TRUE(table_page->InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+  EXPECT_EQ(1, row.GetRowId().GetSlotNum());
+  table_page->RollbackDelete(RowId(7, 4), nullptr, nullptr);
+  EXPECT_TRUE(table_page->IsTupleLive(4));
+  table_page->Compact();
+  EXPECT_FALSE(table_page->HasLiveSlots());
+  EXPECT_EQ(6, table_page->GetLiveTupleCount());
+  for (uint32_t i = 0; i < 6; i++) {
+    Row tuple(RowId(7, i));
+    ASSERT_TRUE(table_page->GetTuple(&tuple, &schema, nullptr, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, tuple.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, static_cast<int32_t>(i))));
+  }
+}
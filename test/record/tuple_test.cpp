@@ -5,6 +5,7 @@
 #include "page/table_page.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
@@ -93,15 +94,51 @@ TEST(TupleTest, RowTest) {
   ASSERT_EQ(row.GetRowId(), first_tuple_rid);
   Row row2(row.GetRowId());
   ASSERT_TRUE(table_page.GetTuple(&row2, schema.get(), nullptr, nullptr));
-  std::vector<Field *> &row2_fields = row2.GetFields();
-  ASSERT_EQ(3, row2_fields.size());
-  for (size_t i = 0; i < row2_fields.size(); i++) {
-    ASSERT_EQ(CmpBool::kTrue, row2_fields[i]->CompareEquals(fields[i]));
+  ASSERT_EQ(3, row2.GetFieldCount());
+  for (size_t i = 0; i < row2.GetFieldCount(); i++) {
+    ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
 }
 
+TEST(TupleTest, RowBufferTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("note", TypeId::kTypeChar, 64, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeChar)};
+
+  /* 1. 拷贝出的行有自己的字符串数据，原行销毁后仍然有效 */
+  auto *row = new Row(fields);
+  Row copy(*row);
+  ASSERT_NE(row->GetField(1)->GetData(), copy.GetField(1)->GetData());
+  delete row;
+  ASSERT_EQ(3, copy.GetFieldCount());
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (fields[i].IsNull()) {
+      ASSERT_TRUE(copy.GetField(i)->IsNull());
+    } else {
+      ASSERT_EQ(CmpBool::kTrue, copy.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+
+  /* 2. 移动只接管缓冲，不拷贝数据 */
+  const char *data = copy.GetField(1)->GetData();
+  Row moved(std::move(copy));
+  ASSERT_EQ(0, copy.GetFieldCount());
+  ASSERT_EQ(data, moved.GetField(1)->GetData());
+
+  /* 3. 键可以取回到行自身 */
+  std::vector<Column *> key_columns = {new Column("name", TypeId::kTypeChar, 64, 0, true, false)};
+  auto key_schema = std::make_shared<Schema>(key_columns);
+  moved.GetKeyFromRow(schema.get(), key_schema.get(), moved);
+  ASSERT_EQ(1, moved.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, moved.GetField(0)->CompareEquals(fields[1]));
+}
+
 TEST(TupleTest, RecordTest) {
   std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
                                    new Column("name", TypeId::kTypeChar, 64, 1, true, false),
@@ -161,4 +198,51 @@ TEST(TupleTest, RecordTest) {
   delete schema;
   delete row;
   delete out;
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewOverflowTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("payload", TypeId::kTypeChar, 8192, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::string payload(5000, 'p');
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 7),
+                               Field(TypeId::kTypeChar, const_cast<char *>(payload.c_str()), payload.size(), true),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)};
+  Row row(fields);
+
+  /* 1. 溢出字段只占长度和溢出页号 */
+  std::vector<page_id_t> overflow_pages = {INVALID_PAGE_ID, 42, INVALID_PAGE_ID};
+  uint32_t size = row.GetSerializedSize(schema.get(), overflow_pages);
+  EXPECT_EQ(row.GetSerializedSize(schema.get()) - payload.size() + sizeof(page_id_t), size);
+  std::vector<char> buf(size);
+  ASSERT_EQ(size, row.SerializeTo(buf.data(), schema.get(), overflow_pages));
+
+  /* 2. 只有访问溢出字段时才读溢出页 */
+  int reads = 0;
+  RowView::OverflowReader reader = [&](page_id_t first_page_id, uint32_t len, char *data) {
+    EXPECT_EQ(42, first_page_id);
+    ASSERT_EQ(payload.size(), len);
+    memcpy(data, payload.c_str(), len);
+    reads++;
+  };
+  RowView view;
+  view.Reset(buf.data(), schema.get(), RowId(1, 2), &reader);
+  EXPECT_FALSE(view.IsOverflow(0));
+  EXPECT_TRUE(view.IsOverflow(1));
+  EXPECT_EQ(42, view.GetOverflowPageId(1));
+  EXPECT_EQ(CmpBool::kTrue, view.GetField(2).CompareEquals(fields[2]));
+  Row projected;
+  view.ToRow({2, 0}, &projected);
+  EXPECT_EQ(0, reads);
+  EXPECT_EQ(CmpBool::kTrue, view.GetField(1).CompareEquals(fields[1]));
+  EXPECT_EQ(1, reads);
+
+  /* 3. 拷贝出的行持有溢出字段的数据 */
+  Row copied;
+  view.ToRow(&copied);
+  view.Reset(nullptr, schema.get(), RowId());
+  ASSERT_EQ(3, copied.GetFieldCount());
+  for (size_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(CmpBool::kTrue, copied.GetField(i)->CompareEquals(fields[i]));
+  }
+}
@@ -1,7 +1,10 @@
 #include "storage/disk_manager.h"
 
+#include <stdexcept>
 #include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
@@ -56,4 +59,223 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, AllocationPersistenceTest) {
+  std::string db_name = "disk_alloc_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const page_id_t page_nums = DiskManager::BITMAP_SIZE + 100;
+  for (page_id_t i = 0; i < page_nums; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+
+  // Scenario: freed pages are reused, the lowest extent with free pages first.
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 7);
+  disk_mgr->DeAllocatePage(70);
+  disk_mgr->DeAllocatePage(3);
+  EXPECT_EQ(3, disk_mgr->AllocatePage());
+  EXPECT_EQ(70, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 7, disk_mgr->AllocatePage());
+  EXPECT_EQ(page_nums, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(5);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the cached bitmaps are written back on close.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(page_nums, meta_page->GetAllocatedPages());
+  EXPECT_TRUE(disk_mgr->IsPageFree(5));
+  EXPECT_FALSE(disk_mgr->IsPageFree(6));
+  EXPECT_FALSE(disk_mgr->IsPageFree(page_nums));
+  EXPECT_TRUE(disk_mgr->IsPageFree(page_nums + 1));
+  EXPECT_EQ(5, disk_mgr->AllocatePage());
+  EXPECT_EQ(page_nums + 1, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ReadWritePageTest) {
+  for (bool direct_io : {false, true}) {
+    std::string db_name = "disk_io_test.db";
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, direct_io);
+    const int page_nums = 64;
+    std::vector<char> data(PAGE_SIZE * page_nums);
+    char buf[PAGE_SIZE + 1];
+
+    // Scenario: pages that were never written read back as zeros.
+    ASSERT_EQ(0, disk_mgr->AllocatePage());
+    disk_mgr->ReadPage(0, buf + 1);
+    for (int i = 0; i < PAGE_SIZE; i++) {
+      ASSERT_EQ(0, buf[i + 1]);
+    }
+
+    // Scenario: single writes from unaligned buffers and batched writes read back the same.
+    std::vector<std::pair<page_id_t, const char *>> batch;
+    for (int i = 0; i < page_nums; i++) {
+      memset(data.data() + i * PAGE_SIZE, 'a' + i % 26, PAGE_SIZE);
+      data[i * PAGE_SIZE] = static_cast<char>(i);
+      if (i % 3 == 0) {
+        memcpy(buf + 1, data.data() + i * PAGE_SIZE, PAGE_SIZE);
+        disk_mgr->WritePage(i, buf + 1);
+      } else {
+        batch.emplace_back(i, data.data() + i * PAGE_SIZE);
+      }
+    }
+    disk_mgr->WritePages(batch);
+    for (int i = 0; i < page_nums; i++) {
+      disk_mgr->ReadPage(i, buf + 1);
+      ASSERT_EQ(0, memcmp(buf + 1, data.data() + i * PAGE_SIZE, PAGE_SIZE));
+    }
+    disk_mgr->Close();
+    delete disk_mgr;
+
+    // Scenario: the data survives reopening the file.
+    disk_mgr = new DiskManager(db_name, direct_io);
+    EXPECT_FALSE(disk_mgr->IsPageFree(0));
+    for (int i = 0; i < page_nums; i++) {
+      disk_mgr->ReadPage(i, buf);
+      ASSERT_EQ(0, memcmp(buf, data.data() + i * PAGE_SIZE, PAGE_SIZE));
+    }
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
+
+TEST(DiskManagerTest, AsyncReadWriteTest) {
+  std::string db_name = "disk_async_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const int page_nums = 128;
+  const int rounds = 8;
+  char buf[PAGE_SIZE];
+
+  // Scenario: overlapping asynchronous writes of the same pages, the latest one wins.
+  std::vector<std::future<void>> futures;
+  for (int round = 0; round < rounds; round++) {
+    std::vector<std::pair<page_id_t, const char *>> batch;
+    std::vector<std::vector<char>> data(page_nums, std::vector<char>(PAGE_SIZE));
+    for (int i = 0; i < page_nums; i++) {
+      memset(data[i].data(), 'a' + round, PAGE_SIZE);
+      data[i][0] = static_cast<char>(i);
+      if (i % 2 == 0) {
+        futures.push_back(disk_mgr->WritePageAsync(i, data[i].data()));
+      } else {
+        batch.emplace_back(i, data[i].data());
+      }
+    }
+    futures.push_back(disk_mgr->WritePagesAsync(batch));
+    // the data was copied, scribbling over it must not matter
+    for (auto &page : data) {
+      memset(page.data(), 0, PAGE_SIZE);
+    }
+    // Scenario: a synchronous read right after the submission sees the data in flight.
+    disk_mgr->ReadPage(page_nums - 1, buf);
+    EXPECT_EQ(static_cast<char>(page_nums - 1), buf[0]);
+    EXPECT_EQ('a' + round, buf[PAGE_SIZE - 1]);
+  }
+
+  // Scenario: a batch of asynchronous reads queued behind the writes sees the last round.
+  std::vector<std::vector<char>> read_data(page_nums, std::vector<char>(PAGE_SIZE));
+  std::vector<std::pair<page_id_t, char *>> read_batch;
+  for (int i = 0; i < page_nums; i++) {
+    read_batch.emplace_back(i, read_data[i].data());
+  }
+  disk_mgr->ReadPagesAsync(read_batch).wait();
+  for (int i = 0; i < page_nums; i++) {
+    EXPECT_EQ(static_cast<char>(i), read_data[i][0]);
+    EXPECT_EQ('a' + rounds - 1, read_data[i][PAGE_SIZE - 1]);
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+
+  // Scenario: a synchronous write after asynchronous ones is not overwritten by them.
+  memset(buf, 'z', PAGE_SIZE);
+  disk_mgr->WritePageAsync(0, buf);
+  memset(buf, 'y', PAGE_SIZE);
+  disk_mgr->WritePage(0, buf);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  disk_mgr = new DiskManager(db_name);
+  disk_mgr->ReadPageAsync(0, buf).wait();
+  EXPECT_EQ('y', buf[0]);
+  for (int i = 1; i < page_nums; i++) {
+    disk_mgr->ReadPage(i, buf);
+    EXPECT_EQ(static_cast<char>(i), buf[0]);
+    EXPECT_EQ('a' + rounds - 1, buf[PAGE_SIZE - 1]);
+  }
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ChecksumTest) {
+  std::string db_name = "disk_checksum_test.db";
+  remove(db_name.c_str());
+  remove((db_name + ".crc").c_str());
+  auto *disk_mgr = new DiskManager(db_name, false, false, true);
+  ASSERT_TRUE(disk_mgr->IsChecksummed());
+  const int page_nums = 16;
+  char buf[PAGE_SIZE];
+  for (int i = 0; i < page_nums; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    memset(buf, 'a' + i, PAGE_SIZE);
+    disk_mgr->WritePage(i, buf);
+  }
+
+  // Scenario: intact pages pass verification.
+  for (int i = 0; i < page_nums; i++) {
+    EXPECT_TRUE(disk_mgr->ReadPage(i, buf));
+  }
+  EXPECT_EQ(0, disk_mgr->GetChecksumFailures());
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: a page overwritten behind the disk manager's back, e.g. half of a torn write, is detected.
+  {
+    FILE *file = fopen(db_name.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    // logical page 3 lies behind the meta page and the first bitmap page
+    fseek(file, (3 + 2) * PAGE_SIZE + PAGE_SIZE / 2, SEEK_SET);
+    fputc('#', file);
+    fclose(file);
+  }
+  disk_mgr = new DiskManager(db_name, false, false, true);
+  for (int i = 0; i < page_nums; i++) {
+    EXPECT_EQ(i != 3, disk_mgr->ReadPage(i, buf));
+  }
+  EXPECT_EQ(1, disk_mgr->GetChecksumFailures());
+  EXPECT_THROW(disk_mgr->ReadPageAsync(3, buf).get(), std::runtime_error);
+  EXPECT_NO_THROW(disk_mgr->ReadPageAsync(4, buf).get());
+
+  // Scenario: the buffer pool does not bring in the corrupt page.
+  {
+    BufferPoolManager bpm(4, disk_mgr, 1);
+    EXPECT_EQ(nullptr, bpm.FetchPage(3));
+    Page *page = bpm.FetchPage(4);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ('a' + 4, page->GetData()[0]);
+    bpm.UnpinPage(4, false);
+    EXPECT_TRUE(bpm.CheckAllUnpinned());
+  }
+
+  // Scenario: rewriting the page records a fresh checksum.
+  memset(buf, 'z', PAGE_SIZE);
+  disk_mgr->WritePage(3, buf);
+  EXPECT_TRUE(disk_mgr->ReadPage(3, buf));
+  EXPECT_EQ(3, disk_mgr->GetChecksumFailures());
+  delete disk_mgr;
+
+  // Scenario: the mapped read-only mode verifies pages as well.
+  disk_mgr = new DiskManager(db_name, false, true, true);
+  for (int i = 0; i < page_nums; i++) {
+    EXPECT_NE(nullptr, disk_mgr->GetPageView(i));
+  }
+  EXPECT_EQ(0, disk_mgr->GetChecksumFailures());
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove((db_name + ".crc").c_str());
+}
@@ -1,5 +1,7 @@
 #include "storage/table_heap.h"
 
+#include <set>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -53,7 +55,7 @@ TEST(TableHeapTest, TableHeapSampleTest) {
     size--;
     Row row(RowId(row_kv.first));
     table_heap->GetTuple(&row, nullptr);
-    ASSERT_EQ(schema.get()->GetColumnCount(), row.GetFields().size());
+    ASSERT_EQ(schema.get()->GetColumnCount(), row.GetFieldCount());
     for (size_t j = 0; j < schema->GetColumnCount(); j++) {
       ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(row_kv.second->at(j)));
     }
@@ -131,3 +133,714 @@ TEST(TableHeapTest, MyTHTest)
   delete bpm_;
   delete disk_mgr_;
 }
+
+TEST(TableHeapTest, PrefetchScanTest) {
+  /* 0. 使用远小于表大小的buffer pool，扫描时需要不断换页 */
+  const std::string db_name = "table_heap_prefetch_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_, 2, kLRUKReplacer);
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'a', sizeof(characters));
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  /* 1. 不同预读窗口下的全表扫描都应看到全部记录，且不遗留pin */
+  for (size_t window : {0, 1, 4, 16}) {
+    table_heap->SetPrefetchWindow(window);
+    std::vector<bool> seen(row_nums, false);
+    int count = 0;
+    for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it, count++) {
+      char buf[sizeof(int32_t)];
+      it->GetField(0)->SerializeTo(buf);
+      int id = MACH_READ_INT32(buf);
+      ASSERT_FALSE(seen[id]);
+      seen[id] = true;
+    }
+    ASSERT_EQ(row_nums, count);
+  }
+  delete table_heap;
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  const std::string db_name = "table_heap_fsm_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  ASSERT_NE(INVALID_PAGE_ID, table_heap->GetFreeSpaceMapPageId());
+  char characters[64];
+  memset(characters, 'a', sizeof(characters));
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // rows fill the pages in chain order
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  EXPECT_EQ(first_page_id, rids.front().GetPageId());
+  page_id_t last_page_id = rids.back().GetPageId();
+
+  /* 1. 删除首页中的若干行，新插入的行应回填到首页 */
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+  for (int i = 0; i < 10; i++) {
+    Fields fields{Field(TypeId::kTypeInt, row_nums + i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    EXPECT_EQ(first_page_id, row.GetRowId().GetPageId());
+  }
+
+  /* 2. 重新打开表，空闲空间映射从磁盘读入，插入继续落在尾页 */
+  page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+  delete table_heap;
+  for (page_id_t map_page_id : {fsm_page_id, INVALID_PAGE_ID}) {
+    table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr, map_page_id);
+    Fields fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    EXPECT_EQ(last_page_id, row.GetRowId().GetPageId());
+    delete table_heap;
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  /* 3. 删除表时空闲空间映射页一并释放 */
+  table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr, fsm_page_id);
+  table_heap->DeleteTable();
+  EXPECT_TRUE(bpm_->IsPageFree(fsm_page_id));
+  EXPECT_TRUE(bpm_->IsPageFree(first_page_id));
+  delete table_heap;
+
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, InsertTuplesTest) {
+  const std::string db_name = "table_heap_batch_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'b', sizeof(characters));
+
+  /* 1. 分两批插入，第二批先回填第一批最后一页 */
+  std::vector<RowId> rids;
+  for (int begin : {0, row_nums / 2}) {
+    std::vector<Row> rows;
+    for (int i = begin; i < begin + row_nums / 2; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)};
+      rows.emplace_back(fields);
+    }
+    ASSERT_TRUE(table_heap->InsertTuples(rows, nullptr));
+    for (auto &row : rows) {
+      rids.push_back(row.GetRowId());
+    }
+  }
+  EXPECT_EQ(table_heap->GetFirstPageId(), rids.front().GetPageId());
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  /* 2. 按插入顺序扫描得到全部行 */
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    EXPECT_EQ(rids[count].Get(), iter->GetRowId().Get());
+    EXPECT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, count)));
+    count++;
+  }
+  EXPECT_EQ(row_nums, count);
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, VacuumTest) {
+  const std::string db_name = "table_heap_vacuum_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'v', sizeof(characters));
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+
+  /* 1. 只保留每页的第一行和最后一页，其余行全部删除 */
+  std::set<page_id_t> kept_pages, emptied_pages;
+  std::vector<int> kept_rows;
+  for (int i = 0; i < row_nums; i++) {
+    page_id_t page_id = rids[i].GetPageId();
+    bool keep = (i == 0 || page_id != rids[i - 1].GetPageId()) && page_id % 2 == 0;
+    if (keep || page_id == rids.back().GetPageId() || page_id == table_heap->GetFirstPageId()) {
+      kept_rows.push_back(i);
+      kept_pages.insert(page_id);
+      continue;
+    }
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    table_heap->ApplyDelete(rids[i], nullptr);
+    emptied_pages.insert(page_id);
+  }
+  for (auto page_id : kept_pages) {
+    emptied_pages.erase(page_id);
+  }
+  ASSERT_FALSE(emptied_pages.empty());
+
+  /* 2. 空页被释放，剩余行按原顺序扫描得到 */
+  size_t reclaimed = table_heap->Vacuum(nullptr);
+  EXPECT_GE(reclaimed, emptied_pages.size() * PAGE_SIZE);
+  for (auto page_id : emptied_pages) {
+    EXPECT_TRUE(bpm_->IsPageFree(page_id));
+  }
+  size_t count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    ASSERT_LT(count, kept_rows.size());
+    EXPECT_EQ(rids[kept_rows[count]].Get(), iter->GetRowId().Get());
+    count++;
+  }
+  EXPECT_EQ(kept_rows.size(), count);
+  EXPECT_EQ(0, table_heap->Vacuum(nullptr));
+
+  /* 3. 重建的空闲空间映射只含剩余页 */
+  for (int i = 0; i < 100; i++) {
+    Fields fields{Field(TypeId::kTypeInt, row_nums + i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    EXPECT_EQ(1, kept_pages.count(row.GetRowId().GetPageId()));
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, UpdateInPlaceTest) {
+  const std::string db_name = "table_heap_update_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 1024, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::string name(1000, 'u');
+  std::vector<RowId> rids;
+  for (int i = 0; i < 3; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), 16, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+
+  /* 1. 同样大小、变大和变小的元组都原地更新，RowId不变 */
+  for (uint32_t len : {16, 600, 8}) {
+    Fields fields{Field(TypeId::kTypeInt, 10), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), len, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[1], nullptr));
+    Row result(rids[1]);
+    ASSERT_TRUE(table_heap->GetTuple(&result, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, result.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 10)));
+    EXPECT_EQ(len, result.GetField(1)->GetLength());
+  }
+  for (int i : {0, 2}) {
+    Row result(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&result, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, result.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+
+  /* 2. 页内放不下时更新失败，原元组不变 */
+  for (int i = 0; i < 3; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), 1000, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+  }
+  Fields filler_fields{Field(TypeId::kTypeInt, 3), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), 600, true)};
+  Row filler(filler_fields);
+  ASSERT_TRUE(table_heap->InsertTuple(filler, nullptr));
+  ASSERT_EQ(rids[1].GetPageId(), filler.GetRowId().GetPageId());
+  std::string large(1500, 'w');
+  Fields large_fields{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar, const_cast<char *>(large.c_str()), 1500, true)};
+  EXPECT_FALSE(table_heap->UpdateTuple(Row(large_fields), rids[1], nullptr));
+  Row result(rids[1]);
+  ASSERT_TRUE(table_heap->GetTuple(&result, nullptr));
+  EXPECT_EQ(1000, result.GetField(1)->GetLength());
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, ScanCursorTest) {
+  const std::string db_name = "table_heap_cursor_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 1000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  std::vector<std::string> names;
+  for (int i = 0; i < row_nums; i++) {
+    names.push_back(std::string(i % 50 + 1, 'a' + i % 26));
+    // every third name and every fifth account is null
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 3 == 0 ? Field(TypeId::kTypeChar)
+                             : Field(TypeId::kTypeChar, const_cast<char *>(names[i].c_str()), names[i].size(), true),
+                  i % 5 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, static_cast<float>(i) / 2)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  for (int i = 0; i < row_nums; i += 7) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+
+  /* 1. 游标跳过已删除的行，逐个字段读出的值与插入时一致 */
+  int count = 0;
+  {
+    TableScanCursor cursor(table_heap);
+    for (int i = 0; i < row_nums; i++) {
+      if (i % 7 == 0) continue;
+      ASSERT_TRUE(cursor.Next());
+      const RowView &view = cursor.Get();
+      ASSERT_EQ(rids[i].Get(), view.GetRowId().Get());
+      // read the fields back to front, so that later offsets are decoded first
+      EXPECT_EQ(i % 5 == 0, view.IsNull(2));
+      if (i % 5 != 0) {
+        EXPECT_EQ(CmpBool::kTrue, view.GetField(2).CompareEquals(Field(TypeId::kTypeFloat, static_cast<float>(i) / 2)));
+      }
+      EXPECT_EQ(i % 3 == 0, view.GetField(1).IsNull());
+      if (i % 3 != 0) {
+        EXPECT_EQ(names[i], std::string(view.GetField(1).GetData(), view.GetField(1).GetLength()));
+      }
+      EXPECT_EQ(CmpBool::kTrue, view.GetField(0).CompareEquals(Field(TypeId::kTypeInt, i)));
+
+      /* 2. 拷贝出的行与GetTuple读出的行一致 */
+      Row row, projected, expected(rids[i]);
+      view.ToRow(&row);
+      view.ToRow({2, 0}, &projected);
+      ASSERT_TRUE(table_heap->GetTuple(&expected, nullptr));
+      ASSERT_EQ(3, row.GetFieldCount());
+      for (uint32_t j = 0; j < 3; j++) {
+        EXPECT_EQ(expected.GetField(j)->IsNull(), row.GetField(j)->IsNull());
+        if (!expected.GetField(j)->IsNull()) {
+          EXPECT_EQ(CmpBool::kTrue, expected.GetField(j)->CompareEquals(*row.GetField(j)));
+        }
+      }
+      ASSERT_EQ(2, projected.GetFieldCount());
+      EXPECT_EQ(CmpBool::kTrue, projected.GetField(1)->CompareEquals(Field(TypeId::kTypeInt, i)));
+      EXPECT_EQ(rids[i].Get(), projected.GetRowId().Get());
+      count++;
+    }
+    EXPECT_FALSE(cursor.Next());
+    // the cursor gives up its last pin once the scan is over
+    EXPECT_TRUE(bpm_->CheckAllUnpinned());
+  }
+  EXPECT_EQ(row_nums - (row_nums + 6) / 7, count);
+
+  /* 3. 提前关闭的游标不留下pin */
+  {
+    TableScanCursor cursor(table_heap);
+    ASSERT_TRUE(cursor.Next());
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, PageRangeCursorTest) {
+  const std::string db_name = "table_heap_range_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  std::string name(60, 'x');
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+
+  /* 1. 空闲空间映射给出的页与页链表一致 */
+  std::vector<page_id_t> page_ids = table_heap->GetPageIds();
+  std::vector<page_id_t> chain;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    if (chain.empty() || chain.back() != iter->GetRowId().GetPageId()) {
+      chain.push_back(iter->GetRowId().GetPageId());
+    }
+  }
+  ASSERT_EQ(chain, page_ids);
+  ASSERT_GT(page_ids.size(), 8);
+
+  /* 2. 多个线程各扫一段页，按段拼接后与顺序扫描一致 */
+  const size_t range_pages = 3;
+  size_t range_count = (page_ids.size() + range_pages - 1) / range_pages;
+  std::vector<std::vector<int64_t>> range_rids(range_count);
+  std::vector<std::thread> workers;
+  for (size_t r = 0; r < range_count; r++) {
+    workers.emplace_back([&, r] {
+      auto end = page_ids.begin() + std::min((r + 1) * range_pages, page_ids.size());
+      TableScanCursor cursor(table_heap, std::vector<page_id_t>(page_ids.begin() + r * range_pages, end));
+      while (cursor.Next()) {
+        range_rids[r].push_back(cursor.Get().GetRowId().Get());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  std::vector<int64_t> scanned;
+  for (auto &range : range_rids) {
+    scanned.insert(scanned.end(), range.begin(), range.end());
+  }
+  ASSERT_EQ(rids.size(), scanned.size());
+  for (size_t i = 0; i < rids.size(); i++) {
+    EXPECT_EQ(rids[i].Get(), scanned[i]);
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  /* 3. 空的页列表什么也不返回 */
+  {
+    TableScanCursor cursor(table_heap, {});
+    EXPECT_FALSE(cursor.Next());
+  }
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, PageDirectoryTest) {
+  const std::string db_name = "table_heap_directory_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_, 2);
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::string name(60, 'x');
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  /* 1. 页目录按链表顺序给出每一页 */
+  std::vector<page_id_t> chain;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_GT(chain.size(), 32);
+  ASSERT_EQ(chain.size(), table_heap->GetPageCount());
+  for (size_t i = 0; i < chain.size(); i++) {
+    EXPECT_EQ(chain[i], table_heap->GetPageIdAt(i));
+  }
+
+  /* 2. 重新打开的表从持久化的目录读出同样的页 */
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+  delete table_heap;
+  table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr, fsm_page_id);
+  EXPECT_EQ(chain, table_heap->GetPageIds());
+
+  /* 3. 删除表按目录释放所有页，缓冲池容不下整张表也没有问题 */
+  table_heap->DeleteTable();
+  for (auto page_id : chain) {
+    EXPECT_TRUE(bpm_->IsPageFree(page_id));
+  }
+  EXPECT_TRUE(bpm_->IsPageFree(fsm_page_id));
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, SparsePageScanTest) {
+  const std::string db_name = "table_heap_sparse_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_, 2);
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+
+  /* 1. 每页只留少量行：大部分删除，一部分只标记删除，一部分标记后回滚 */
+  std::vector<int> kept_rows;
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 37 == 0) {
+      kept_rows.push_back(i);
+    } else if (i % 37 == 1) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      table_heap->RollbackDelete(rids[i], nullptr);
+      kept_rows.push_back(i);
+    } else if (i % 5 == 0) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    } else {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      table_heap->ApplyDelete(rids[i], nullptr);
+    }
+  }
+
+  /* 2. 扫描按槽位顺序跳过所有空槽与已删除槽 */
+  size_t count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    ASSERT_LT(count, kept_rows.size());
+    EXPECT_EQ(rids[kept_rows[count]].Get(), iter->GetRowId().Get());
+    EXPECT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, kept_rows[count])));
+    count++;
+  }
+  EXPECT_EQ(kept_rows.size(), count);
+
+  /* 3. 重用的空槽重新出现在扫描中 */
+  Fields fields{Field(TypeId::kTypeInt, row_nums)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    count++;
+  }
+  EXPECT_EQ(kept_rows.size() + 1, count);
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, OverflowFieldTest) {
+  const std::string db_name = "table_heap_overflow_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_, 2);
+  const int row_nums = 200;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("payload", TypeId::kTypeChar, 16000, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  // payloads from a few bytes up to several pages, the long ones go to overflow pages
+  auto payload_of = [](int i) { return std::string(i % 4 == 0 ? 10 : 500 * (i % 30 + 1), 'a' + i % 26); };
+
+  /* 1. 单行与批量插入都能存下远超一页的字段 */
+  std::vector<RowId> rids;
+  std::vector<Row> batch;
+  for (int i = 0; i < row_nums; i++) {
+    std::string payload = payload_of(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(payload.c_str()), payload.size(), true)};
+    if (i < row_nums / 2) {
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    } else {
+      batch.emplace_back(fields);
+    }
+  }
+  ASSERT_TRUE(table_heap->InsertTuples(batch, nullptr));
+  for (auto &row : batch) {
+    rids.push_back(row.GetRowId());
+  }
+  // the tuples themselves stay small, a page holds many of them
+  EXPECT_LT(table_heap->GetPageCount(), 5);
+
+  /* 2. GetTuple、迭代器与游标读出完整字段 */
+  for (int i = 0; i < row_nums; i++) {
+    Row row(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    EXPECT_EQ(payload_of(i), std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+  }
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    EXPECT_EQ(payload_of(count), std::string(iter->GetField(1)->GetData(), iter->GetField(1)->GetLength()));
+    count++;
+  }
+  EXPECT_EQ(row_nums, count);
+  {
+    TableScanCursor cursor(table_heap);
+    for (int i = 0; i < row_nums; i++) {
+      ASSERT_TRUE(cursor.Next());
+      EXPECT_EQ(payload_of(i).size() > OVERFLOW_FIELD_SIZE, cursor.Get().IsOverflow(1));
+      Row row;
+      cursor.Get().ToRow(&row);
+      EXPECT_EQ(payload_of(i), std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+    }
+    EXPECT_FALSE(cursor.Next());
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  /* 3. 带溢出字段的行不原地更新；删除时溢出页一并释放 */
+  // row 29 has the longest payload, spread over several overflow pages
+  const int victim = 29;
+  std::string payload = payload_of(victim);
+  Fields fields{Field(TypeId::kTypeInt, victim), Field(TypeId::kTypeChar, const_cast<char *>("x"), 1, true)};
+  EXPECT_FALSE(table_heap->UpdateTuple(Row(fields), rids[victim], nullptr));
+  std::vector<page_id_t> overflow_pages;
+  {
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(rids[victim].GetPageId()));
+    RowView view;
+    view.Reset(page->GetTupleData(rids[victim].GetSlotNum()), schema.get(), rids[victim]);
+    ASSERT_TRUE(view.IsOverflow(1));
+    for (page_id_t page_id = view.GetOverflowPageId(1); page_id != INVALID_PAGE_ID;) {
+      overflow_pages.push_back(page_id);
+      auto overflow_page = bpm_->FetchPage(page_id);
+      page_id_t next_page_id = reinterpret_cast<OverflowPage *>(overflow_page->GetData())->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    bpm_->UnpinPage(rids[victim].GetPageId(), false);
+  }
+  EXPECT_EQ((payload.size() + OverflowPage::MAX_DATA_SIZE - 1) / OverflowPage::MAX_DATA_SIZE, overflow_pages.size());
+  ASSERT_TRUE(table_heap->MarkDelete(rids[victim], nullptr));
+  table_heap->ApplyDelete(rids[victim], nullptr);
+  for (auto page_id : overflow_pages) {
+    EXPECT_TRUE(bpm_->IsPageFree(page_id));
+  }
+
+  /* 4. 删除表释放所有溢出页 */
+  page_id_t last_page_id;
+  bpm_->NewPage(last_page_id);
+  bpm_->UnpinPage(last_page_id, false);
+  bpm_->DeletePage(last_page_id);
+  table_heap->DeleteTable();
+  for (page_id_t page_id = 0; page_id < last_page_id; page_id++) {
+    EXPECT_TRUE(bpm_->IsPageFree(page_id));
+  }
+  delete table_heap;
+
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, ProjectionCursorTest) {
+  const std::string db_name = "table_heap_projection_test.db";
+  remove(db_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_name);
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_, 2);
+  const int row_nums = 300;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 16000, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 64, 3, true, false),
+                                   new Column("rank", TypeId::kTypeInt, 4, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  // some names go to overflow pages, every third name and every fifth account is null
+  auto name_of = [](int i) { return std::string(i % 10 == 1 ? 3000 : i % 50 + 1, 'a' + i % 26); };
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = name_of(i), note = std::to_string(i * 7);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 3 == 0 ? Field(TypeId::kTypeChar)
+                             : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                  i % 5 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, static_cast<float>(i) / 2),
+                  Field(TypeId::kTypeChar, const_cast<char *>(note.c_str()), note.size(), true),
+                  Field(TypeId::kTypeInt, -i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  /* 1. 只读部分列的游标与读全部列的游标取出的值一致，列可以乱序、重复 */
+  std::vector<uint32_t> read_columns{3, 1, 3, 2};
+  RowProjection projection(schema.get(), read_columns);
+  EXPECT_TRUE(projection.Contains(1));
+  EXPECT_FALSE(projection.Contains(0));
+  EXPECT_FALSE(projection.Contains(4));
+  {
+    TableScanCursor full(table_heap), projected(table_heap);
+    projected.SetProjection(&projection);
+    for (int i = 0; i < row_nums; i++) {
+      ASSERT_TRUE(full.Next());
+      ASSERT_TRUE(projected.Next());
+      Row expected, row;
+      full.Get().ToRow(read_columns, &expected);
+      projected.Get().ToRow(read_columns, &row);
+      ASSERT_EQ(read_columns.size(), row.GetFieldCount());
+      for (uint32_t j = 0; j < read_columns.size(); j++) {
+        ASSERT_EQ(expected.GetField(j)->IsNull(), row.GetField(j)->IsNull());
+        if (!row.GetField(j)->IsNull()) {
+          ASSERT_EQ(CmpBool::kTrue, expected.GetField(j)->CompareEquals(*row.GetField(j)));
+        }
+      }
+      ASSERT_EQ(std::to_string(i * 7), std::string(row.GetField(0)->GetData(), row.GetField(0)->GetLength()));
+    }
+    EXPECT_FALSE(projected.Next());
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  table_heap->DeleteTable();
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_name.c_str());
+}